@@ -26,6 +26,7 @@ class Aircraft : public Entity
 	public:
 								Aircraft(Type type, const TextureHolder& textures, const FontHolder& fonts);
 
+		Type					getType() const;
 		virtual unsigned int	getCategory() const;
 		virtual sf::FloatRect	getBoundingRect() const;
 		virtual void			remove();
@@ -49,6 +50,7 @@ class Aircraft : public Entity
 
 	private:
 		virtual void			drawCurrent(sf::RenderTarget& target, sf::RenderStates states) const;
+		virtual void			collectCurrentStatistics(SceneStatistics& statistics) const;
 		virtual void 			updateCurrent(sf::Time dt, CommandQueue& commands);
 		void					updateMovementPattern(sf::Time dt);
 		void					checkPickupDrop(CommandQueue& commands);
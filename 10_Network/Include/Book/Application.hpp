@@ -2,11 +2,15 @@
 #define BOOK_APPLICATION_HPP
 
 #include <Book/ResourceHolder.hpp>
+#include <Book/ResourceLoader.hpp>
+#include <Book/AssetArchive.hpp>
 #include <Book/ResourceIdentifiers.hpp>
 #include <Book/KeyBinding.hpp>
 #include <Book/StateStack.hpp>
 #include <Book/MusicPlayer.hpp>
 #include <Book/SoundPlayer.hpp>
+#include <Book/Statistics.hpp>
+#include <Book/PerformanceOverlay.hpp>
 
 #include <SFML/System/Time.hpp>
 #include <SFML/Graphics/RenderWindow.hpp>
@@ -26,17 +30,25 @@ class Application
 		void					render();
 
 		void					updateStatistics(sf::Time dt);
+		void					toggleProfilerCapture();
 		void					registerStates();
 
 
 	private:
 		static const sf::Time	TimePerFrame;
+		static const sf::Time	LoadingTimePerFrame;
+		static const std::size_t	TextureMemoryBudget;
+		static const float		MinResolutionScale;
 
 		sf::RenderWindow		mWindow;
+		AssetArchive			mArchive;
+		ResourceLoader			mLoader;
 		TextureHolder			mTextures;
 	  	FontHolder				mFonts;
+		ShaderHolder			mShaders;
 		MusicPlayer				mMusic;
 		SoundPlayer				mSounds;
+		Statistics				mStatistics;
 
 		KeyBinding				mKeyBinding1;
 		KeyBinding				mKeyBinding2;
@@ -45,6 +57,10 @@ class Application
 		sf::Text				mStatisticsText;
 		sf::Time				mStatisticsUpdateTime;
 		std::size_t				mStatisticsNumFrames;
+
+		PerformanceOverlay		mOverlay;
+		sf::Time				mUpdateTime;
+		sf::Time				mRenderTime;
 };
 
 #endif // BOOK_APPLICATION_HPP
@@ -0,0 +1,54 @@
+#ifndef BOOK_ASSETARCHIVE_HPP
+#define BOOK_ASSETARCHIVE_HPP
+
+#include <Book/MappedFile.hpp>
+
+#include <SFML/Config.hpp>
+#include <SFML/System/NonCopyable.hpp>
+
+#include <map>
+#include <string>
+#include <vector>
+
+
+// Read-only, memory-mapped pack of media files. Entries are addressed by their path relative
+// to the chapter directory (e.g. "Media/Textures/Entities.png") and stay valid while the archive is open.
+//
+// Layout (little endian): header { char magic[4]; Uint32 version; Uint32 entryCount; Uint32 reserved; },
+// then per entry { Uint32 nameLength; Uint32 reserved; Uint64 offset; Uint64 size; char name[nameLength]; },
+// then the entry data, each starting at a multiple of Alignment.
+class AssetArchive : private sf::NonCopyable
+{
+	public:
+		struct Entry
+		{
+			const void*			data;
+			std::size_t			size;
+		};
+
+
+	public:
+		static const sf::Uint32		Version = 1;
+		static const std::size_t	Alignment = 16;
+
+
+	public:
+		explicit					AssetArchive(const std::string& filename);
+									~AssetArchive();
+
+		bool						isOpen() const;
+		const Entry*				find(const std::string& name) const;
+
+		static bool					pack(const std::string& filename, const std::vector<std::string>& inputFiles);
+
+
+	private:
+		bool						readIndex();
+
+
+	private:
+		MappedFile						mFile;
+		std::map<std::string, Entry>	mEntries;
+};
+
+#endif // BOOK_ASSETARCHIVE_HPP
@@ -0,0 +1,48 @@
+#ifndef BOOK_BACKGROUNDNODE_HPP
+#define BOOK_BACKGROUNDNODE_HPP
+
+#include <Book/SceneNode.hpp>
+
+#include <SFML/Graphics/Vertex.hpp>
+
+#include <vector>
+
+
+// Vertically endless background, built from horizontal chunks of texture tiles.
+// Only the chunks overlapping the view are kept in one vertex array; chunks leaving the view are
+// overwritten by the ones entering it, so memory does not depend on the level length.
+class BackgroundNode : public SceneNode
+{
+	public:
+		// The texture holds 'variations' equally wide, tileable images side by side.
+		// Each tile picks one of them, depending only on its position.
+								BackgroundNode(const sf::Texture& texture, float width, std::size_t variations = 1);
+
+		// Vertical offsets passed to rebase() must be whole multiples of it
+		float					getChunkHeight() const;
+		virtual void			rebase(sf::Vector2f offset);
+
+
+	private:
+		virtual void			drawCurrent(sf::RenderTarget& target, sf::RenderStates states) const;
+		virtual void			collectCurrentStatistics(SceneStatistics& statistics) const;
+
+		void					updateChunks(sf::FloatRect visibleArea) const;
+		void					buildChunk(int chunk, std::size_t slot) const;
+
+
+	private:
+		const sf::Texture&				mTexture;
+		float							mWidth;
+		std::size_t						mVariations;
+		sf::Vector2f					mTileSize;
+		std::size_t						mColumns;
+		int								mChunkBase;
+
+		// Ring of chunk slots; a slot holds chunk c if c modulo the slot count equals its index.
+		// Chunk indices are local, mChunkBase turns them into the index a chunk had before any rebase.
+		mutable std::vector<int>		mSlotChunks;
+		mutable std::vector<sf::Vertex>	mVertices;
+};
+
+#endif // BOOK_BACKGROUNDNODE_HPP
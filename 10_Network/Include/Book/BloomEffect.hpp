@@ -11,20 +11,26 @@
 #include <array>
 
 
+class RenderTargetPool;
+class ResourceLoader;
+
 class BloomEffect : public PostEffect
 {
 	public:
-							BloomEffect();
+							BloomEffect(RenderTargetPool& renderTargets, ShaderHolder& shaders);
+
+		static void			loadShaders(ResourceLoader& loader, ShaderHolder& shaders);
 
 		virtual void		apply(const sf::RenderTexture& input, sf::RenderTarget& output);
 
 
 	private:
-		typedef std::array<sf::RenderTexture, 2> RenderTextureArray;
+		typedef std::array<sf::RenderTexture*, 2> RenderTextureArray;
 
 
 	private:
-		void				prepareTextures(sf::Vector2u size);
+		void				acquireTextures(RenderTextureArray& renderTextures, sf::Vector2u size);
+		void				releaseTextures(RenderTextureArray& renderTextures);
 
 		void				filterBright(const sf::RenderTexture& input, sf::RenderTexture& output);
 		void				blurMultipass(RenderTextureArray& renderTextures);
@@ -34,11 +40,8 @@ class BloomEffect : public PostEffect
 
 
 	private:
-		ShaderHolder		mShaders;
-
-		sf::RenderTexture	mBrightnessTexture;
-		RenderTextureArray	mFirstPassTextures;
-		RenderTextureArray	mSecondPassTextures;
+		ShaderHolder&		mShaders;
+		RenderTargetPool&	mRenderTargets;
 };
 
 #endif // BOOK_BLOOMEFFECT_HPP
@@ -2,6 +2,7 @@
 #define BOOK_COMMAND_HPP
 
 #include <Book/Category.hpp>
+#include <Book/HandleTable.hpp>
 
 #include <SFML/System/Time.hpp>
 
@@ -19,6 +20,10 @@ struct Command
 
 	Action						action;
 	unsigned int				category;
+
+	// If valid, the command goes to this player aircraft only (see World::getAircraftHandle()) and the
+	// category is ignored. Commands for aircraft that no longer exist are dropped.
+	Handle						target;
 };
 
 template <typename GameObject, typename Function>
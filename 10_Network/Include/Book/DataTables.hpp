@@ -55,6 +55,14 @@ struct ParticleData
 {
 	sf::Color						color;
 	sf::Time						lifetime;
+	std::size_t						capacity;
+};
+
+struct SoundEffectData
+{
+	int								priority;
+	std::size_t						maxVoices;
+	float							cullDistance;
 };
 
 
@@ -62,5 +70,6 @@ std::vector<AircraftData>	initializeAircraftData();
 std::vector<ProjectileData>	initializeProjectileData();
 std::vector<PickupData>		initializePickupData();
 std::vector<ParticleData>	initializeParticleData();
+std::vector<SoundEffectData>	initializeSoundEffectData();
 
 #endif // BOOK_DATATABLES_HPP
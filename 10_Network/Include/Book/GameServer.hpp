@@ -1,6 +1,8 @@
 #ifndef BOOK_GAMESERVER_HPP
 #define BOOK_GAMESERVER_HPP
 
+#include <Book/MpscQueue.hpp>
+
 #include <SFML/System/Vector2.hpp>
 #include <SFML/System/Thread.hpp>
 #include <SFML/System/Clock.hpp>
@@ -10,28 +12,68 @@
 #include <SFML/Network/TcpSocket.hpp>
 
 #include <vector>
+#include <deque>
 #include <memory>
-#include <map>
+#include <atomic>
+
 
+class LocalChannel;
+class ServerConnection;
 
+
+// Runs in its own thread. The public functions may be called from any thread: they post a call to
+// the server's mailbox, which the server thread works off at the start of each loop iteration.
 class GameServer
 {
 	public:
 		explicit							GameServer(sf::Vector2f battlefieldSize);
 											~GameServer();
 
+		// Connects the hosting client through memory instead of a loopback socket
+		std::unique_ptr<ServerConnection>	connectLocal();
+
 		void								notifyPlayerSpawn(sf::Int32 aircraftIdentifier);
 		void								notifyPlayerRealtimeChange(sf::Int32 aircraftIdentifier, sf::Int32 action, bool actionEnabled);
 		void								notifyPlayerEvent(sf::Int32 aircraftIdentifier, sf::Int32 action);
 
 
 	private:
+		// Call from another thread, executed on the server thread
+		struct Call
+		{
+			enum Type
+			{
+				ConnectLocal,
+				PlayerSpawn,
+				PlayerRealtimeChange,
+				PlayerEvent,
+			};
+
+											Call();
+
+			Type							type;
+			sf::Int32						aircraftIdentifier;
+			sf::Int32						action;
+			bool							actionEnabled;
+			std::shared_ptr<LocalChannel>	channel;
+		};
+
 		// A GameServerRemotePeer refers to one instance of the game, may it be local or from another computer
 		struct RemotePeer
 		{
 									RemotePeer();
+									~RemotePeer();
+
+			void					send(sf::Packet& packet);
+			bool					receive(sf::Packet& packet, sf::Int32& packetType);
+			void					flushOverflow();
+
+			// Back to a waiting peer, ready to accept the next connection
+			void					reset();
 
 			sf::TcpSocket			socket;
+			std::shared_ptr<LocalChannel>	channel;	// Set for the hosting client, which has no socket
+			std::deque<sf::Packet>	overflow;	// Messages that didn't fit into the channel, sent before newer ones
 			sf::Time				lastPacketTime;
 			std::vector<sf::Int32>	aircraftIdentifiers;
 			bool					ready;
@@ -44,7 +86,8 @@ class GameServer
 			sf::Vector2f				position;
 			sf::Int32					hitpoints;
 			sf::Int32                   missileAmmo;
-			std::map<sf::Int32, bool>	realtimeActions;
+			sf::Uint32					realtimeActions;	// One bit per PlayerAction
+			bool						inUse;				// Slot belongs to a peer, even after the aircraft died
 		};
 
 		// Unique pointer to remote peers
@@ -54,20 +97,32 @@ class GameServer
 	private:
 		void								setListening(bool enable);
 		void								executionThread();
+		void								postCall(const Call& call);
+		void								handleCalls();
 		void								tick();
 		sf::Time							now() const;
 
 		void								handleIncomingPackets();
-		void								handleIncomingPacket(sf::Packet& packet, RemotePeer& receivingPeer, bool& detectedTimeout);
+		void								handleIncomingPacket(sf::Int32 packetType, sf::Packet& packet, RemotePeer& receivingPeer, bool& detectedTimeout);
 
 		void								handleIncomingConnections();
+		void								acceptPeer(RemotePeer& peer);
 		void								handleDisconnections();
 
-		void								informWorldState(sf::TcpSocket& socket);
+		void								sendPlayerSpawn(sf::Int32 aircraftIdentifier);
+		void								sendPlayerRealtimeChange(sf::Int32 aircraftIdentifier, sf::Int32 action, bool actionEnabled);
+		void								sendPlayerEvent(sf::Int32 aircraftIdentifier, sf::Int32 action);
+
+		void								informWorldState(RemotePeer& peer);
 		void								broadcastMessage(const std::string& message);
 		void								sendToAll(sf::Packet& packet);
 		void								updateClientState();
 
+		sf::Int32							createAircraft();
+		void								destroyAircraft(sf::Int32 identifier);
+		AircraftInfo*						findAircraft(sf::Int32 identifier);
+		bool								isAlive(const AircraftInfo& aircraft) const;
+
 
 	private:
 		sf::Thread							mThread;
@@ -83,15 +138,23 @@ class GameServer
 		sf::FloatRect						mBattleFieldRect;
 		float								mBattleFieldScrollSpeed;
 
+		// Slots are reused through the free lists; an aircraft's identifier is its slot index + 1
 		std::size_t							mAircraftCount;
-		std::map<sf::Int32, AircraftInfo>	mAircraftInfo;
+		std::vector<AircraftInfo>			mAircraftInfo;
+		std::vector<std::size_t>			mFreeAircraftSlots;
 
+		// One slot per possible player. The next connection is accepted into the last free slot.
 		std::vector<PeerPtr>				mPeers;
-		sf::Int32							mAircraftIdentifierCounter;
-		bool								mWaitingThreadEnd;
+		std::vector<std::size_t>			mFreePeerSlots;
+		std::atomic<bool>					mWaitingThreadEnd;
 		
 		sf::Time							mLastSpawnTime;
 		sf::Time							mTimeForNextSpawn;
+
+		MpscQueue<Call>						mMailbox;
+
+		// Local clients waiting for a free peer slot; server thread only
+		std::vector<std::shared_ptr<LocalChannel>>	mPendingLocalChannels;
 };
 
 #endif // BOOK_GAMESERVER_HPP
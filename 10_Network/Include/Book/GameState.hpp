@@ -12,11 +12,12 @@
 class GameState : public State
 {
 	public:
-							GameState(StateStack& stack, Context context);
+							GameState(StateStack& stack, Context context, bool endless = false);
 
 		virtual void		draw();
 		virtual bool		update(sf::Time dt);
 		virtual bool		handleEvent(const sf::Event& event);
+		virtual void		setInterpolation(float alpha);
 
 
 	private:
@@ -0,0 +1,50 @@
+#ifndef BOOK_HANDLETABLE_HPP
+#define BOOK_HANDLETABLE_HPP
+
+#include <SFML/Config.hpp>
+
+#include <vector>
+#include <cassert>
+
+
+// Weak reference to an object in a HandleTable: slot index and the slot's generation when the handle was made.
+// Removing an object advances its slot's generation, so old handles to it resolve to nothing.
+struct Handle
+{
+								Handle();
+
+	bool						isValid() const;
+
+	sf::Uint32					index;
+	sf::Uint32					generation;		// 0 for handles that never referred to anything
+};
+
+// O(1) insertion, removal and lookup. Freed slots are reused, the table only grows to the peak object count.
+template <typename T>
+class HandleTable
+{
+	public:
+									HandleTable();
+
+		Handle						insert(T& object);
+		void						remove(Handle handle);
+
+		// Null if the handle's object was removed
+		T*							get(Handle handle) const;
+
+
+	private:
+		struct Slot
+		{
+			T*						object;
+			sf::Uint32				generation;
+		};
+
+
+	private:
+		std::vector<Slot>			mSlots;
+		std::vector<sf::Uint32>		mFreeSlots;
+};
+
+#include "HandleTable.inl"
+#endif // BOOK_HANDLETABLE_HPP
@@ -0,0 +1,50 @@
+
+template <typename T>
+HandleTable<T>::HandleTable()
+: mSlots()
+, mFreeSlots()
+{
+}
+
+template <typename T>
+Handle HandleTable<T>::insert(T& object)
+{
+	if (mFreeSlots.empty())
+	{
+		Slot slot = { nullptr, 1 };
+		mFreeSlots.push_back(static_cast<sf::Uint32>(mSlots.size()));
+		mSlots.push_back(slot);
+	}
+
+	Handle handle;
+	handle.index = mFreeSlots.back();
+	handle.generation = mSlots[handle.index].generation;
+
+	mFreeSlots.pop_back();
+	mSlots[handle.index].object = &object;
+	return handle;
+}
+
+template <typename T>
+void HandleTable<T>::remove(Handle handle)
+{
+	assert(get(handle) != nullptr);
+
+	Slot& slot = mSlots[handle.index];
+	slot.object = nullptr;
+
+	// Skip 0 on wrap-around, it is reserved for invalid handles
+	if (++slot.generation == 0)
+		slot.generation = 1;
+
+	mFreeSlots.push_back(handle.index);
+}
+
+template <typename T>
+T* HandleTable<T>::get(Handle handle) const
+{
+	if (handle.index >= mSlots.size() || mSlots[handle.index].generation != handle.generation)
+		return nullptr;
+
+	return mSlots[handle.index].object;
+}
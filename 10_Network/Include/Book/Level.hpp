@@ -0,0 +1,47 @@
+#ifndef BOOK_LEVEL_HPP
+#define BOOK_LEVEL_HPP
+
+#include <Book/MappedFile.hpp>
+#include <Book/Aircraft.hpp>
+
+#include <SFML/System/NonCopyable.hpp>
+
+#include <string>
+#include <vector>
+
+
+// Enemy spawns of a level, in a binary file sorted by distance and memory-mapped.
+// Spawns are decoded on access, so only the pages of spawns that are actually reached are loaded.
+class Level : private sf::NonCopyable
+{
+	public:
+		struct Spawn
+		{
+											Spawn();
+											Spawn(Aircraft::Type type, float x, float distance);
+
+			Aircraft::Type					type;
+			float							x;			// Relative to the horizontal center
+			float							distance;	// Scroll distance from the start
+		};
+
+
+	public:
+										Level();
+
+		// Throws std::runtime_error on a missing or malformed file
+		void							loadFromFile(const std::string& filename);
+
+		std::size_t						getSpawnCount() const;
+		Spawn							getSpawn(std::size_t index) const;
+
+		// Sorts the spawns by distance before writing them
+		static bool						save(const std::string& filename, std::vector<Spawn> spawns);
+
+
+	private:
+		MappedFile						mFile;
+		std::size_t						mSpawnCount;
+};
+
+#endif // BOOK_LEVEL_HPP
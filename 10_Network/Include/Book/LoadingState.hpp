@@ -0,0 +1,30 @@
+#ifndef BOOK_LOADINGSTATE_HPP
+#define BOOK_LOADINGSTATE_HPP
+
+#include <Book/State.hpp>
+
+#include <SFML/Graphics/Text.hpp>
+#include <SFML/Graphics/RectangleShape.hpp>
+
+
+// Shows progress while the game's resources load in the background, then replaces itself with the game state
+class LoadingState : public State
+{
+	public:
+							LoadingState(StateStack& stack, Context context, States::ID nextState);
+
+		virtual void		draw();
+		virtual bool		update(sf::Time dt);
+		virtual bool		handleEvent(const sf::Event& event);
+
+		void				setCompletion(float percent);
+
+
+	private:
+		sf::Text			mLoadingText;
+		sf::RectangleShape	mProgressBarBackground;
+		sf::RectangleShape	mProgressBar;
+		States::ID			mNextState;
+};
+
+#endif // BOOK_LOADINGSTATE_HPP
@@ -0,0 +1,51 @@
+#ifndef BOOK_LOCALCHANNEL_HPP
+#define BOOK_LOCALCHANNEL_HPP
+
+#include <Book/ServerConnection.hpp>
+#include <Book/SpscQueue.hpp>
+
+#include <SFML/System/NonCopyable.hpp>
+#include <SFML/System/Clock.hpp>
+
+#include <atomic>
+
+
+// In-memory link between the hosting client (game thread) and its embedded GameServer (server thread).
+// Messages are handed over through one lock-free queue per direction, without sockets or syscalls.
+class LocalChannel : private sf::NonCopyable
+{
+	public:
+		typedef ServerConnection::Message Message;
+
+
+	public:
+									LocalChannel();
+
+		// Client side
+		bool						sendToServer(const sf::Packet& packet);
+		bool						pollClientMessage(Message& message);
+		std::size_t					getPendingClientMessageCount() const;
+
+		// Server side
+		bool						sendToClient(const sf::Packet& packet);
+		bool						pollServerMessage(Message& message);
+
+		// Either side; the other one sees a disconnection
+		void						close();
+		bool						isClosed() const;
+
+		sf::Time					now() const;
+
+
+	private:
+		bool						push(SpscQueue<Message>& queue, const sf::Packet& packet);
+
+
+	private:
+		sf::Clock					mClock;
+		SpscQueue<Message>			mToClient;
+		SpscQueue<Message>			mToServer;
+		std::atomic<bool>			mClosed;
+};
+
+#endif // BOOK_LOCALCHANNEL_HPP
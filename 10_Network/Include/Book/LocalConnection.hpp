@@ -0,0 +1,39 @@
+#ifndef BOOK_LOCALCONNECTION_HPP
+#define BOOK_LOCALCONNECTION_HPP
+
+#include <Book/ServerConnection.hpp>
+
+#include <memory>
+
+
+class LocalChannel;
+
+// Hosting client's end of a LocalChannel, created by GameServer::connectLocal()
+class LocalConnection : public ServerConnection
+{
+	public:
+		explicit					LocalConnection(std::shared_ptr<LocalChannel> channel);
+		virtual						~LocalConnection();
+
+		virtual Status				getStatus() const;
+		virtual sf::Time			now() const;
+
+		virtual sf::Time			getResolveTime() const;
+		virtual sf::Time			getConnectTime() const;
+		virtual std::size_t			getConnectAttempts() const;
+
+		virtual bool				send(const sf::Packet& packet);
+		virtual bool				pollMessage(Message& message);
+		virtual std::size_t			getPendingMessageCount() const;
+
+		virtual std::size_t			getBytesReceived() const;
+		virtual std::size_t			getBytesSent() const;
+
+
+	private:
+		std::shared_ptr<LocalChannel>	mChannel;
+		std::size_t					mBytesReceived;
+		std::size_t					mBytesSent;
+};
+
+#endif // BOOK_LOCALCONNECTION_HPP
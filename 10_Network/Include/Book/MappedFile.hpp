@@ -0,0 +1,31 @@
+#ifndef BOOK_MAPPEDFILE_HPP
+#define BOOK_MAPPEDFILE_HPP
+
+#include <SFML/System/NonCopyable.hpp>
+
+#include <string>
+
+
+// Read-only memory mapping of a whole file. The operating system loads pages on first access,
+// so parts of the file that are never read cost no I/O.
+class MappedFile : private sf::NonCopyable
+{
+	public:
+									MappedFile();
+									~MappedFile();
+
+		// Empty files cannot be mapped and fail to open
+		bool						open(const std::string& filename);
+		void						close();
+
+		bool						isOpen() const;
+		const char*					getData() const;
+		std::size_t					getSize() const;
+
+
+	private:
+		const char*					mData;
+		std::size_t					mSize;
+};
+
+#endif // BOOK_MAPPEDFILE_HPP
@@ -0,0 +1,56 @@
+#ifndef BOOK_MPSCQUEUE_HPP
+#define BOOK_MPSCQUEUE_HPP
+
+#include <SFML/System/NonCopyable.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+
+// Bounded lock-free queue for any number of producer threads and exactly one consumer thread.
+// Every slot carries a sequence number telling whose turn it is, so producers only contend on the tail index.
+template <typename T>
+class MpscQueue : private sf::NonCopyable
+{
+	public:
+		// Capacity is rounded up to a power of two
+		explicit					MpscQueue(std::size_t capacity);
+
+		// Producer side, from any thread; returns false if the queue is full
+		bool						push(const T& value);
+
+		// Consumer side; returns false if the queue is empty
+		bool						pop(T& value);
+
+		std::size_t					capacity() const;
+
+
+	private:
+		struct Cell
+		{
+			std::atomic<std::size_t>	sequence;
+			T							value;
+		};
+
+		// Keeps the producers' and consumer's indices on different cache lines
+		struct CacheLinePadding
+		{
+			char					bytes[64];
+		};
+
+
+	private:
+		std::unique_ptr<Cell[]>		mCells;
+		std::size_t					mMask;
+
+		CacheLinePadding			mPadding0;
+		std::atomic<std::size_t>	mHead;		// Next slot to read, written by the consumer
+		CacheLinePadding			mPadding1;
+		std::atomic<std::size_t>	mTail;		// Next slot to claim, shared by the producers
+		CacheLinePadding			mPadding2;
+};
+
+#include "MpscQueue.inl"
+#endif // BOOK_MPSCQUEUE_HPP
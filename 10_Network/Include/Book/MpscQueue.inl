@@ -0,0 +1,78 @@
+
+template <typename T>
+MpscQueue<T>::MpscQueue(std::size_t capacity)
+: mCells()
+, mMask(0)
+, mHead(0)
+, mTail(0)
+{
+	std::size_t size = 1;
+	while (size < capacity)
+		size *= 2;
+
+	// A slot is free for the producer claiming position p when its sequence equals p
+	mCells.reset(new Cell[size]);
+	for (std::size_t i = 0; i < size; ++i)
+		mCells[i].sequence.store(i, std::memory_order_relaxed);
+
+	mMask = size - 1;
+}
+
+template <typename T>
+bool MpscQueue<T>::push(const T& value)
+{
+	std::size_t tail = mTail.load(std::memory_order_relaxed);
+	Cell* cell;
+
+	for (;;)
+	{
+		cell = &mCells[tail & mMask];
+		std::ptrdiff_t difference = static_cast<std::ptrdiff_t>(cell->sequence.load(std::memory_order_acquire) - tail);
+
+		// Free slot: claim it. Otherwise the queue is full, or another producer claimed it first.
+		if (difference == 0)
+		{
+			if (mTail.compare_exchange_weak(tail, tail + 1, std::memory_order_relaxed))
+				break;
+		}
+		else if (difference < 0)
+		{
+			return false;
+		}
+		else
+		{
+			tail = mTail.load(std::memory_order_relaxed);
+		}
+	}
+
+	cell->value = value;
+
+	// Publishes the slot's contents to the consumer
+	cell->sequence.store(tail + 1, std::memory_order_release);
+	return true;
+}
+
+template <typename T>
+bool MpscQueue<T>::pop(T& value)
+{
+	std::size_t head = mHead.load(std::memory_order_relaxed);
+	Cell& cell = mCells[head & mMask];
+
+	// Claimed but not yet written slots count as empty, their producer is still busy
+	if (cell.sequence.load(std::memory_order_acquire) != head + 1)
+		return false;
+
+	// Moved out, so the cell doesn't keep resources alive until it is reused
+	value = std::move(cell.value);
+
+	// Hands the slot to the producer of the next round
+	cell.sequence.store(head + mMask + 1, std::memory_order_release);
+	mHead.store(head + 1, std::memory_order_relaxed);
+	return true;
+}
+
+template <typename T>
+std::size_t MpscQueue<T>::capacity() const
+{
+	return mMask + 1;
+}
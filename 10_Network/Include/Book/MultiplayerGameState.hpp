@@ -6,10 +6,10 @@
 #include <Book/Player.hpp>
 #include <Book/GameServer.hpp>
 #include <Book/NetworkProtocol.hpp>
+#include <Book/ServerConnection.hpp>
 
 #include <SFML/System/Clock.hpp>
 #include <SFML/Graphics/Text.hpp>
-#include <SFML/Network/TcpSocket.hpp>
 #include <SFML/Network/Packet.hpp>
 
 
@@ -22,14 +22,37 @@ class MultiplayerGameState : public State
 		virtual bool				update(sf::Time dt);
 		virtual bool				handleEvent(const sf::Event& event);
 		virtual void				onActivate();
+		virtual void				setInterpolation(float alpha);
 		void						onDestroy();
 
 		void						disableAllRealtimeActions();
 
+		// Limits the server packets handled per frame; packets beyond it stay queued
+		void						setPacketBudget(std::size_t maxPackets, sf::Time maxTime);
+		std::size_t					getPacketQueueDepth() const;
+
+
+	private:
+		// Connection setup advances one step per frame, so the game keeps rendering meanwhile
+		enum ConnectionPhase
+		{
+			Resolving,
+			Connecting,
+			Handshaking,
+			Connected,
+			Disconnected
+		};
+
 
 	private:
 		void						updateBroadcastMessage(sf::Time elapsedTime);
 		void						handlePacket(sf::Int32 packetType, sf::Packet& packet);
+		bool						receivePackets();
+		void						updateTrafficStatistics();
+
+		void						updateConnection();
+		void						failConnection(const std::string& message);
+		void						setConnectionText(const std::string& message);
 
 
 	private:
@@ -43,8 +66,6 @@ class MultiplayerGameState : public State
 
 		std::map<int, PlayerPtr>	mPlayers;
 		std::vector<sf::Int32>		mLocalPlayerIdentifiers;
-		sf::TcpSocket				mSocket;
-		bool						mConnected;
 		std::unique_ptr<GameServer> mGameServer;
 		sf::Clock					mTickClock;
 
@@ -64,6 +85,22 @@ class MultiplayerGameState : public State
 		bool						mGameStarted;
 		sf::Time					mClientTimeout;
 		sf::Time					mTimeSinceLastPacket;
+
+		std::unique_ptr<ServerConnection>	mConnection;
+		ServerConnection::Message	mMessage;		// Reused, keeps its packet buffer
+		ConnectionPhase				mConnectionPhase;
+		sf::Clock					mConnectionClock;
+		sf::Time					mConnectTime;
+		bool						mReceivedInitialState;
+
+		std::size_t					mPacketBudget;
+		sf::Time					mPacketTimeBudget;
+		std::size_t					mPeakPacketQueueDepth;
+		sf::Time					mPeakPacketDelay;
+
+		sf::Clock					mTrafficClock;
+		std::size_t					mLastBytesReceived;
+		std::size_t					mLastBytesSent;
 };
 
 #endif // BOOK_MULTIPLAYERGAMESTATE_HPP
@@ -3,30 +3,59 @@
 
 #include <Book/ResourceHolder.hpp>
 #include <Book/ResourceIdentifiers.hpp>
+#include <Book/MusicTrack.hpp>
 
 #include <SFML/System/NonCopyable.hpp>
-#include <SFML/Audio/Music.hpp>
+#include <SFML/System/Time.hpp>
 
 #include <map>
+#include <memory>
 #include <string>
 
 
 class MusicPlayer : private sf::NonCopyable
 {
 	public:
-									MusicPlayer();
+									MusicPlayer(ResourceLoader& loader, const AssetArchive& archive);
 
+		void						prefetch(Music::ID theme);
 		void						play(Music::ID theme);
 		void						stop();
+		void						update(sf::Time dt);
 
 		void						setPaused(bool paused);
 		void						setVolume(float volume);
+		void						setCrossfadeDuration(sf::Time duration);
 
 
 	private:
-		sf::Music							mMusic;
+		struct Track
+		{
+			std::shared_ptr<MusicTrack>	music;
+			ResourceLoader::Handle		opened;
+			float						gain;
+		};
+
+
+	private:
+		Track&						getTrack(Music::ID theme);
+		void						start(Music::ID theme);
+
+
+	private:
+		ResourceLoader&						mLoader;
+		const AssetArchive&					mArchive;
 		std::map<Music::ID, std::string>	mFilenames;
+		std::map<Music::ID, Track>			mTracks;
+
+		Music::ID							mCurrentTheme;
+		Music::ID							mPendingTheme;
+		bool								mHasCurrentTheme;
+		bool								mHasPendingTheme;
+
+		sf::Time							mCrossfadeDuration;
 		float								mVolume;
+		bool								mPaused;
 };
 
 #endif // BOOK_MUSICPLAYER_HPP
@@ -0,0 +1,42 @@
+#ifndef BOOK_MUSICTRACK_HPP
+#define BOOK_MUSICTRACK_HPP
+
+#include <SFML/Audio/Music.hpp>
+
+#include <string>
+#include <vector>
+
+
+class AssetArchive;
+
+// Streamed music that keeps the decoded samples of its first seconds. When the track is
+// started again, the cached head is played while the decoder seeks past it.
+class MusicTrack : public sf::Music
+{
+	public:
+		explicit				MusicTrack(sf::Time headDuration);
+
+		bool					open(const std::string& filename, const AssetArchive& archive);
+
+
+	protected:
+		virtual bool			onGetData(Chunk& data);
+		virtual void			onSeek(sf::Time timeOffset);
+
+
+	private:
+		sf::Time				getHeadDuration() const;
+
+
+	private:
+		sf::Time				mHeadDuration;
+		std::vector<sf::Int16>	mHead;
+		bool					mHeadComplete;
+		bool					mHeadIsWholeTrack;
+		bool					mCapturing;
+
+		bool					mServingHead;
+		std::size_t				mHeadPosition;
+};
+
+#endif // BOOK_MUSICTRACK_HPP
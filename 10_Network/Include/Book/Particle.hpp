@@ -1,11 +1,8 @@
 #ifndef BOOK_PARTICLE_HPP
 #define BOOK_PARTICLE_HPP
 
-#include <SFML/System/Vector2.hpp>
-#include <SFML/System/Time.hpp>
-#include <SFML/Graphics/Color.hpp>
-
 
+// Particle attributes are stored per system, see ParticleNode
 struct Particle 
 {
 	enum Type
@@ -14,10 +11,6 @@ struct Particle
 		Smoke,
 		ParticleCount
 	};
-
-	sf::Vector2f	position;
-	sf::Color		color;
-	sf::Time		lifetime;
 };
 
 #endif // BOOK_PARTICLE_HPP
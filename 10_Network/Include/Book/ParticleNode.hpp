@@ -5,9 +5,10 @@
 #include <Book/ResourceIdentifiers.hpp>
 #include <Book/Particle.hpp>
 
-#include <SFML/Graphics/VertexArray.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+#include <SFML/Graphics/Color.hpp>
 
-#include <deque>
+#include <vector>
 
 
 class ParticleNode : public SceneNode
@@ -17,24 +18,38 @@ class ParticleNode : public SceneNode
 
 		void					addParticle(sf::Vector2f position);
 		Particle::Type			getParticleType() const;
+		std::size_t				getParticleCount() const;
 		virtual unsigned int	getCategory() const;
+		virtual void			rebase(sf::Vector2f offset);
 
 
 	private:
 		virtual void			updateCurrent(sf::Time dt, CommandQueue& commands);
 		virtual void			drawCurrent(sf::RenderTarget& target, sf::RenderStates states) const;
+		virtual void			collectCurrentStatistics(SceneStatistics& statistics) const;
 		
-		void					addVertex(float worldX, float worldY, float texCoordX, float texCoordY, const sf::Color& color) const;
 		void					computeVertices() const;
+		void					computeSegment(std::size_t first, std::size_t count, std::size_t outputOffset) const;
 
 
 	private:
-		std::deque<Particle>	mParticles;
-		const sf::Texture&		mTexture;
-		Particle::Type			mType;
-
-		mutable sf::VertexArray	mVertexArray;
-		mutable bool			mNeedsVertexUpdate;
+		// Particle attributes as structure of arrays, used as fixed-capacity ring buffer.
+		// Particles are stored in emission order, so the oldest one is always at mFirst.
+		std::vector<float>				mPositionsX;
+		std::vector<float>				mPositionsY;
+		std::vector<float>				mExpiryTimes;
+		std::size_t						mFirst;
+		std::size_t						mCount;
+		float							mElapsedTime;
+
+		const sf::Texture&				mTexture;
+		Particle::Type					mType;
+		sf::Color						mColor;
+		float							mLifetime;
+
+		mutable std::vector<float>		mFadeFactors;
+		mutable std::vector<sf::Vertex>	mVertices;
+		mutable bool					mNeedsVertexUpdate;
 };
 
 #endif // BOOK_PARTICLENODE_HPP
@@ -0,0 +1,68 @@
+#ifndef BOOK_PERFORMANCEOVERLAY_HPP
+#define BOOK_PERFORMANCEOVERLAY_HPP
+
+#include <SFML/System/NonCopyable.hpp>
+#include <SFML/System/Time.hpp>
+#include <SFML/Graphics/Drawable.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+#include <SFML/Graphics/Color.hpp>
+#include <SFML/Graphics/Rect.hpp>
+
+#include <vector>
+#include <string>
+
+
+namespace sf
+{
+	class Font;
+}
+
+class Statistics;
+
+// Frame-time graph with percentile lows, followed by the values in Statistics.
+// Graph and text are built from glyph quads of a single font page, so the overlay is one draw call.
+class PerformanceOverlay : public sf::Drawable, private sf::NonCopyable
+{
+	public:
+		explicit					PerformanceOverlay(const Statistics& statistics);
+
+		void						setFont(const sf::Font& font);
+		void						setVisible(bool visible);
+		bool						isVisible() const;
+
+		// Call once per rendered frame; the update and render times are part of the frame time
+		void						addFrame(sf::Time frameTime, sf::Time updateTime, sf::Time renderTime);
+
+
+	private:
+		virtual void				draw(sf::RenderTarget& target, sf::RenderStates states) const;
+
+		void						buildText();
+		void						buildVertices();
+		sf::Time					getPercentileFrameTime(float percentile) const;
+
+		void						appendRect(std::vector<sf::Vertex>& vertices, sf::FloatRect rect, sf::Color color) const;
+		sf::Vector2f				appendText(std::vector<sf::Vertex>& vertices, const std::string& text, sf::Vector2f position) const;
+
+
+	private:
+		const sf::Font*				mFont;
+		const Statistics&			mStatistics;
+		bool						mVisible;
+
+		// Ring buffer, long enough for meaningful 0.1% lows
+		std::vector<sf::Time>		mFrameTimes;
+		std::size_t					mNextFrame;
+		std::size_t					mFrameCount;
+
+		// Averaged over the text's refresh interval
+		sf::Time					mTextElapsedTime;
+		sf::Time					mUpdateTime;
+		sf::Time					mRenderTime;
+		std::size_t					mTextFrames;
+
+		std::vector<sf::Vertex>		mTextVertices;
+		std::vector<sf::Vertex>		mVertices;
+};
+
+#endif // BOOK_PERFORMANCEOVERLAY_HPP
@@ -34,6 +34,7 @@ class Pickup : public Entity
 
 	protected:
 		virtual void			drawCurrent(sf::RenderTarget& target, sf::RenderStates states) const;
+		virtual void			collectCurrentStatistics(SceneStatistics& statistics) const;
 
 
 	private:
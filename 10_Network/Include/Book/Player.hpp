@@ -6,12 +6,12 @@
 
 #include <SFML/System/NonCopyable.hpp>
 #include <SFML/Window/Event.hpp>
-#include <SFML/Network/TcpSocket.hpp>
 
 #include <map>
 
 
 class CommandQueue;
+class ServerConnection;
 
 class Player : private sf::NonCopyable
 {
@@ -27,7 +27,7 @@ class Player : private sf::NonCopyable
 
 
 	public:
-								Player(sf::TcpSocket* socket, sf::Int32 identifier, const KeyBinding* binding);
+								Player(ServerConnection* connection, sf::Int32 identifier, const KeyBinding* binding);
 
 		void					handleEvent(const sf::Event& event, CommandQueue& commands);
 		void					handleRealtimeInput(CommandQueue& commands);
@@ -40,6 +40,9 @@ class Player : private sf::NonCopyable
 		void 					setMissionStatus(MissionStatus status);
 		MissionStatus 			getMissionStatus() const;
 
+		// Commands go directly to this aircraft instead of being matched against all player aircraft
+		void					setAircraft(Handle aircraft);
+
 		void					disableAllRealtimeActions();
 		bool					isLocal() const;
 
@@ -54,7 +57,7 @@ class Player : private sf::NonCopyable
 		std::map<Action, bool>		mActionProxies;
 		MissionStatus 				mCurrentMissionStatus;
 		int							mIdentifier;
-		sf::TcpSocket*				mSocket;
+		ServerConnection*			mConnection;
 };
 
 #endif // BOOK_PLAYER_HPP
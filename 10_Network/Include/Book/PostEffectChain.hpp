@@ -0,0 +1,33 @@
+#ifndef BOOK_POSTEFFECTCHAIN_HPP
+#define BOOK_POSTEFFECTCHAIN_HPP
+
+#include <Book/PostEffect.hpp>
+
+#include <vector>
+#include <memory>
+
+
+class RenderTargetPool;
+
+// Applies several effects in sequence. Intermediate results are stored in targets of the shared pool.
+class PostEffectChain : public PostEffect
+{
+	public:
+		typedef std::unique_ptr<PostEffect> Ptr;
+
+
+	public:
+		explicit				PostEffectChain(RenderTargetPool& renderTargets);
+
+		void					addEffect(Ptr effect);
+		bool					isEmpty() const;
+
+		virtual void			apply(const sf::RenderTexture& input, sf::RenderTarget& output);
+
+
+	private:
+		RenderTargetPool&		mRenderTargets;
+		std::vector<Ptr>		mEffects;
+};
+
+#endif // BOOK_POSTEFFECTCHAIN_HPP
@@ -0,0 +1,63 @@
+#ifndef BOOK_PROFILER_HPP
+#define BOOK_PROFILER_HPP
+
+#include <Book/Foreach.hpp>
+
+#include <SFML/Config.hpp>
+#include <SFML/System/NonCopyable.hpp>
+
+#include <string>
+
+
+// Zones are only recorded if the build defines BOOK_ENABLE_PROFILER (CMake option of the same name).
+// Example:
+//
+// void World::update(sf::Time dt)
+// {
+//     BOOK_PROFILE_ZONE("World::update");
+//     ...
+// }
+#ifdef BOOK_ENABLE_PROFILER
+	#define BOOK_PROFILE_ZONE(name) ProfileZone BOOK_LINE_ID(profileZone)(name)
+#else
+	#define BOOK_PROFILE_ZONE(name) ((void) 0)
+#endif
+
+
+// Records zones into one ring buffer per thread. Recording does not lock; only the first zone
+// of a thread registers its buffer. Captures are exported in the Chrome trace event format.
+class Profiler
+{
+	public:
+		static void					setThreadName(const std::string& name);
+
+		// Zones already open when a capture starts are not part of it
+		static void					startCapture();
+		static void					stopCapture();
+		static bool					isCapturing();
+
+		// Load the file in chrome://tracing or a compatible viewer
+		static bool					exportChromeTrace(const std::string& filename);
+
+
+	private:
+		friend class ProfileZone;
+
+		static sf::Int64			now();
+		static void					record(const char* name, sf::Int64 start, sf::Int64 end);
+};
+
+// Measures the enclosing scope; name must be a string literal
+class ProfileZone : private sf::NonCopyable
+{
+	public:
+		explicit					ProfileZone(const char* name);
+									~ProfileZone();
+
+
+	private:
+		const char*					mName;
+		sf::Int64					mStart;
+};
+
+#endif // BOOK_PROFILER_HPP
@@ -25,6 +25,7 @@ class Projectile : public Entity
 		void					guideTowards(sf::Vector2f position);
 		bool					isGuided() const;
 
+		Type					getType() const;
 		virtual unsigned int	getCategory() const;
 		virtual sf::FloatRect	getBoundingRect() const;
 		float					getMaxSpeed() const;
@@ -34,6 +35,7 @@ class Projectile : public Entity
 	private:
 		virtual void			updateCurrent(sf::Time dt, CommandQueue& commands);
 		virtual void			drawCurrent(sf::RenderTarget& target, sf::RenderStates states) const;
+		virtual void			collectCurrentStatistics(SceneStatistics& statistics) const;
 
 
 	private:
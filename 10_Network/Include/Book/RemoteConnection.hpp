@@ -0,0 +1,73 @@
+#ifndef BOOK_REMOTECONNECTION_HPP
+#define BOOK_REMOTECONNECTION_HPP
+
+#include <Book/ServerConnection.hpp>
+#include <Book/SpscQueue.hpp>
+
+#include <SFML/System/Thread.hpp>
+#include <SFML/System/Clock.hpp>
+#include <SFML/System/Time.hpp>
+#include <SFML/Network/TcpSocket.hpp>
+#include <SFML/Network/Packet.hpp>
+
+#include <atomic>
+#include <string>
+
+
+// Connection to a GameServer over TCP. A network thread owns the socket: it resolves and
+// connects, then exchanges packets with the game thread through lock-free queues.
+class RemoteConnection : public ServerConnection
+{
+	public:
+									RemoteConnection(const std::string& serverName, unsigned short port, sf::Time timeout);
+		virtual						~RemoteConnection();
+
+		virtual Status				getStatus() const;
+		virtual sf::Time			now() const;
+
+		virtual sf::Time			getResolveTime() const;
+		virtual sf::Time			getConnectTime() const;
+		virtual std::size_t			getConnectAttempts() const;
+
+		// Returns false if the network thread's queue is full
+		virtual bool				send(const sf::Packet& packet);
+		virtual bool				pollMessage(Message& message);
+		virtual std::size_t			getPendingMessageCount() const;
+
+		virtual std::size_t			getBytesReceived() const;
+		virtual std::size_t			getBytesSent() const;
+
+		std::size_t					getDroppedPacketCount() const;
+
+
+	private:
+		void						networkThread();
+		bool						connectToServer();
+		bool						receiveMessage();
+		bool						sendPackets();
+
+
+	private:
+		std::string					mServerName;
+		unsigned short				mPort;
+		sf::Time					mTimeout;
+		sf::Clock					mClock;
+		sf::TcpSocket				mSocket;
+
+		SpscQueue<Message>			mIncoming;
+		SpscQueue<sf::Packet>		mOutgoing;
+		std::size_t					mDroppedPackets;
+		std::atomic<std::size_t>	mBytesReceived;
+		std::atomic<std::size_t>	mBytesSent;
+
+		// Metrics are written before the status is published as Connected
+		std::atomic<int>			mStatus;
+		std::atomic<bool>			mStopRequested;
+		sf::Time					mResolveTime;
+		sf::Time					mConnectTime;
+		std::size_t					mConnectAttempts;
+
+		sf::Thread					mThread;
+};
+
+#endif // BOOK_REMOTECONNECTION_HPP
@@ -0,0 +1,44 @@
+#ifndef BOOK_RENDERTARGETPOOL_HPP
+#define BOOK_RENDERTARGETPOOL_HPP
+
+#include <SFML/System/NonCopyable.hpp>
+#include <SFML/System/Vector2.hpp>
+#include <SFML/Graphics/RenderTexture.hpp>
+
+#include <vector>
+#include <memory>
+
+
+// Hands out render textures by size and format, and recycles them once they are released.
+// Targets which have not been used for a while are destroyed in collectUnused().
+class RenderTargetPool : private sf::NonCopyable
+{
+	public:
+								RenderTargetPool();
+
+		sf::RenderTexture&		acquire(sf::Vector2u size, bool smooth = true, bool depthBuffer = false);
+		void					release(const sf::RenderTexture& target);
+		void					collectUnused();
+
+		std::size_t				getTargetCount() const;
+		std::size_t				getMemoryUsage() const;
+
+
+	private:
+		struct Entry
+		{
+			sf::RenderTexture	texture;
+			sf::Vector2u		size;
+			bool				depthBuffer;
+			bool				inUse;
+			unsigned int		idleFrames;
+		};
+
+		typedef std::unique_ptr<Entry> EntryPtr;
+
+
+	private:
+		std::vector<EntryPtr>	mEntries;
+};
+
+#endif // BOOK_RENDERTARGETPOOL_HPP
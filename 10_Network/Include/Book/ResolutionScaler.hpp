@@ -0,0 +1,53 @@
+#ifndef BOOK_RESOLUTIONSCALER_HPP
+#define BOOK_RESOLUTIONSCALER_HPP
+
+#include <SFML/System/Time.hpp>
+#include <SFML/System/Vector2.hpp>
+
+#include <array>
+
+
+// Dynamic resolution controller: measures recent render times and lowers the
+// render scale when they exceed the budget, or raises it again once they fit.
+class ResolutionScaler
+{
+	public:
+		enum Decision
+		{
+			Kept,
+			Lowered,
+			Raised,
+		};
+
+
+	public:
+								ResolutionScaler(float minScale, sf::Time targetFrameTime);
+
+		void					addFrame(sf::Time frameTime);
+		void					setMinScale(float minScale);
+
+		float					getScale() const;
+		sf::Vector2u			getScaledSize(sf::Vector2u size) const;
+		Decision				getLastDecision() const;
+		sf::Time				getAverageFrameTime() const;
+
+
+	private:
+		void					evaluate();
+
+
+	private:
+		static const std::size_t	SampleCount = 30;
+
+		float							mMinScale;
+		float							mScale;
+		sf::Time						mTargetFrameTime;
+
+		std::array<sf::Time, SampleCount>	mSamples;
+		std::size_t						mSampleIndex;
+		sf::Time						mAverageFrameTime;
+		std::size_t						mStablePeriods;
+		Decision						mLastDecision;
+};
+
+#endif // BOOK_RESOLUTIONSCALER_HPP
@@ -0,0 +1,80 @@
+#ifndef BOOK_RESOURCEDECODER_HPP
+#define BOOK_RESOURCEDECODER_HPP
+
+#include <Book/AssetArchive.hpp>
+
+#include <SFML/Graphics/Image.hpp>
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/Graphics/Shader.hpp>
+#include <SFML/Graphics/Texture.hpp>
+
+#include <memory>
+#include <string>
+
+
+// Splits loading into decode(), which may run on a worker thread, and finalize(), which runs
+// on the thread owning the resource. By default, the whole resource is loaded by decode().
+// Files found in the archive are read from its mapping, others from disk.
+template <typename Resource>
+class ResourceDecoder
+{
+	public:
+		explicit					ResourceDecoder(const AssetArchive* archive);
+
+		bool						decode(const std::string& filename);
+
+		template <typename Parameter>
+		bool						decode(const std::string& filename, const Parameter& secondParam);
+
+		std::unique_ptr<Resource>	finalize();
+
+
+	private:
+		const AssetArchive*			mArchive;
+		std::unique_ptr<Resource>	mResource;
+};
+
+// Textures: the image file is decoded in the background, the upload needs the owning thread's GL context
+template <>
+class ResourceDecoder<sf::Texture>
+{
+	public:
+		explicit						ResourceDecoder(const AssetArchive* archive);
+
+		bool							decode(const std::string& filename);
+		bool							decode(const std::string& filename, const sf::IntRect& area);
+
+		std::unique_ptr<sf::Texture>	finalize();
+
+
+	private:
+		const AssetArchive*				mArchive;
+		sf::Image						mImage;
+		sf::IntRect						mArea;
+};
+
+// Shaders: the sources are read in the background, compilation needs the owning thread's GL context
+template <>
+class ResourceDecoder<sf::Shader>
+{
+	public:
+		explicit						ResourceDecoder(const AssetArchive* archive);
+
+		bool							decode(const std::string& filename, sf::Shader::Type type);
+		bool							decode(const std::string& vertexShaderFilename, const std::string& fragmentShaderFilename);
+
+		std::unique_ptr<sf::Shader>		finalize();
+
+
+	private:
+		bool							readSource(const std::string& filename, std::string& source);
+
+
+	private:
+		const AssetArchive*				mArchive;
+		std::string						mVertexSource;
+		std::string						mFragmentSource;
+};
+
+#include "ResourceDecoder.inl"
+#endif // BOOK_RESOURCEDECODER_HPP
@@ -0,0 +1,38 @@
+
+template <typename Resource>
+ResourceDecoder<Resource>::ResourceDecoder(const AssetArchive* archive)
+: mArchive(archive)
+, mResource()
+{
+}
+
+template <typename Resource>
+bool ResourceDecoder<Resource>::decode(const std::string& filename)
+{
+	mResource.reset(new Resource());
+
+	const AssetArchive::Entry* entry = mArchive ? mArchive->find(filename) : nullptr;
+	if (entry)
+		return mResource->loadFromMemory(entry->data, entry->size);
+
+	return mResource->loadFromFile(filename);
+}
+
+template <typename Resource>
+template <typename Parameter>
+bool ResourceDecoder<Resource>::decode(const std::string& filename, const Parameter& secondParam)
+{
+	mResource.reset(new Resource());
+
+	const AssetArchive::Entry* entry = mArchive ? mArchive->find(filename) : nullptr;
+	if (entry)
+		return mResource->loadFromMemory(entry->data, entry->size, secondParam);
+
+	return mResource->loadFromFile(filename, secondParam);
+}
+
+template <typename Resource>
+std::unique_ptr<Resource> ResourceDecoder<Resource>::finalize()
+{
+	return std::move(mResource);
+}
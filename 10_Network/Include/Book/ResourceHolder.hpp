@@ -1,32 +1,86 @@
 #ifndef BOOK_RESOURCEHOLDER_HPP
 #define BOOK_RESOURCEHOLDER_HPP
 
+#include <Book/ResourceLoader.hpp>
+#include <Book/ResourceDecoder.hpp>
+#include <Book/ResourceIdentifiers.hpp>
+
 #include <map>
 #include <string>
 #include <memory>
 #include <stdexcept>
 #include <cassert>
+#include <limits>
+
+
+// Approximate memory used by a resource, counted against the holder's budget
+std::size_t					estimateMemoryUsage(const sf::Texture& texture);
+std::size_t					estimateMemoryUsage(const sf::SoundBuffer& soundBuffer);
+
+template <typename Resource>
+std::size_t					estimateMemoryUsage(const Resource& resource);
 
 
 template <typename Resource, typename Identifier>
 class ResourceHolder
 {
 	public:
+									ResourceHolder();
+
+		// Files contained in the archive are loaded from it, the archive must outlive the holder
+		void						setArchive(const AssetArchive& archive);
+
 		void						load(Identifier id, const std::string& filename);
 
 		template <typename Parameter>
 		void						load(Identifier id, const std::string& filename, const Parameter& secondParam);
 
+		// Asynchronous loading: the holder must outlive the job, get() is valid once the handle is ready.
+		// While an ID is still loading, further calls return the handle of that load instead of queuing another.
+		ResourceLoader::Handle		loadAsync(ResourceLoader& loader, Identifier id, const std::string& filename);
+
+		template <typename Parameter>
+		ResourceLoader::Handle		loadAsync(ResourceLoader& loader, Identifier id, const std::string& filename, const Parameter& secondParam);
+
 		Resource&					get(Identifier id);
 		const Resource&				get(Identifier id) const;
+		bool						contains(Identifier id) const;
+
+		// Referenced resources stay resident; unreferenced ones are evicted, least recently used first,
+		// once the memory usage exceeds the budget
+		void						acquire(Identifier id);
+		void						release(Identifier id);
+
+		void						setMemoryBudget(std::size_t bytes);
+		std::size_t					getMemoryBudget() const;
+		std::size_t					getMemoryUsage() const;
+		std::size_t					getResourceCount() const;
+
+
+	private:
+		struct Entry
+		{
+			std::unique_ptr<Resource>	resource;
+			std::size_t					references;
+			std::size_t					memoryUsage;
+			std::size_t					lastUse;
+		};
 
 
 	private:
 		void						insertResource(Identifier id, std::unique_ptr<Resource> resource);
+		void						evictUnused();
+		ResourceLoader::Handle		enqueue(ResourceLoader& loader, Identifier id, const std::string& filename,
+										std::shared_ptr<ResourceDecoder<Resource>> decoder, ResourceLoader::Step decode);
 
 
 	private:
-		std::map<Identifier, std::unique_ptr<Resource>>	mResourceMap;
+		std::map<Identifier, Entry>	mResourceMap;
+		std::map<Identifier, ResourceLoader::Handle>	mPendingLoads;
+		const AssetArchive*			mArchive;
+		std::size_t					mMemoryBudget;
+		std::size_t					mMemoryUsage;
+		std::size_t					mUseCounter;
 };
 
 #include "ResourceHolder.inl"
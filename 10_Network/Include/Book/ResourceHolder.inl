@@ -1,10 +1,35 @@
 
+template <typename Resource>
+std::size_t estimateMemoryUsage(const Resource&)
+{
+	// Unknown for fonts and shaders, which are small anyway
+	return 0;
+}
+
+template <typename Resource, typename Identifier>
+ResourceHolder<Resource, Identifier>::ResourceHolder()
+: mResourceMap()
+, mPendingLoads()
+, mArchive(nullptr)
+, mMemoryBudget(std::numeric_limits<std::size_t>::max())
+, mMemoryUsage(0)
+, mUseCounter(0)
+{
+}
+
+template <typename Resource, typename Identifier>
+void ResourceHolder<Resource, Identifier>::setArchive(const AssetArchive& archive)
+{
+	mArchive = &archive;
+}
+
 template <typename Resource, typename Identifier>
 void ResourceHolder<Resource, Identifier>::load(Identifier id, const std::string& filename)
 {
 	// Create and load resource
-	std::unique_ptr<Resource> resource(new Resource());
-	if (!resource->loadFromFile(filename))
+	ResourceDecoder<Resource> decoder(mArchive);
+	std::unique_ptr<Resource> resource;
+	if (!decoder.decode(filename) || !(resource = decoder.finalize()))
 		throw std::runtime_error("ResourceHolder::load - Failed to load " + filename);
 
 	// If loading successful, insert resource to map
@@ -16,21 +41,43 @@ template <typename Parameter>
 void ResourceHolder<Resource, Identifier>::load(Identifier id, const std::string& filename, const Parameter& secondParam)
 {
 	// Create and load resource
-	std::unique_ptr<Resource> resource(new Resource());
-	if (!resource->loadFromFile(filename, secondParam))
+	ResourceDecoder<Resource> decoder(mArchive);
+	std::unique_ptr<Resource> resource;
+	if (!decoder.decode(filename, secondParam) || !(resource = decoder.finalize()))
 		throw std::runtime_error("ResourceHolder::load - Failed to load " + filename);
 
 	// If loading successful, insert resource to map
 	insertResource(id, std::move(resource));
 }
 
+template <typename Resource, typename Identifier>
+ResourceLoader::Handle ResourceHolder<Resource, Identifier>::loadAsync(ResourceLoader& loader, Identifier id, const std::string& filename)
+{
+	auto decoder = std::make_shared<ResourceDecoder<Resource>>(mArchive);
+	return enqueue(loader, id, filename, decoder, [decoder, filename] ()
+	{
+		return decoder->decode(filename);
+	});
+}
+
+template <typename Resource, typename Identifier>
+template <typename Parameter>
+ResourceLoader::Handle ResourceHolder<Resource, Identifier>::loadAsync(ResourceLoader& loader, Identifier id, const std::string& filename, const Parameter& secondParam)
+{
+	auto decoder = std::make_shared<ResourceDecoder<Resource>>(mArchive);
+	return enqueue(loader, id, filename, decoder, [decoder, filename, secondParam] ()
+	{
+		return decoder->decode(filename, secondParam);
+	});
+}
+
 template <typename Resource, typename Identifier>
 Resource& ResourceHolder<Resource, Identifier>::get(Identifier id)
 {
 	auto found = mResourceMap.find(id);
 	assert(found != mResourceMap.end());
 
-	return *found->second;
+	return *found->second.resource;
 }
 
 template <typename Resource, typename Identifier>
@@ -39,13 +86,126 @@ const Resource& ResourceHolder<Resource, Identifier>::get(Identifier id) const
 	auto found = mResourceMap.find(id);
 	assert(found != mResourceMap.end());
 
-	return *found->second;
+	return *found->second.resource;
+}
+
+template <typename Resource, typename Identifier>
+bool ResourceHolder<Resource, Identifier>::contains(Identifier id) const
+{
+	return mResourceMap.find(id) != mResourceMap.end();
+}
+
+template <typename Resource, typename Identifier>
+void ResourceHolder<Resource, Identifier>::acquire(Identifier id)
+{
+	auto found = mResourceMap.find(id);
+	assert(found != mResourceMap.end());
+
+	++found->second.references;
+}
+
+template <typename Resource, typename Identifier>
+void ResourceHolder<Resource, Identifier>::release(Identifier id)
+{
+	auto found = mResourceMap.find(id);
+	assert(found != mResourceMap.end());
+	assert(found->second.references > 0);
+
+	if (--found->second.references == 0)
+	{
+		found->second.lastUse = ++mUseCounter;
+		evictUnused();
+	}
+}
+
+template <typename Resource, typename Identifier>
+void ResourceHolder<Resource, Identifier>::setMemoryBudget(std::size_t bytes)
+{
+	mMemoryBudget = bytes;
+	evictUnused();
+}
+
+template <typename Resource, typename Identifier>
+std::size_t ResourceHolder<Resource, Identifier>::getMemoryBudget() const
+{
+	return mMemoryBudget;
+}
+
+template <typename Resource, typename Identifier>
+std::size_t ResourceHolder<Resource, Identifier>::getMemoryUsage() const
+{
+	return mMemoryUsage;
+}
+
+template <typename Resource, typename Identifier>
+std::size_t ResourceHolder<Resource, Identifier>::getResourceCount() const
+{
+	return mResourceMap.size();
 }
 
 template <typename Resource, typename Identifier>
 void ResourceHolder<Resource, Identifier>::insertResource(Identifier id, std::unique_ptr<Resource> resource) 
 {
-	// Insert and check success
-	auto inserted = mResourceMap.insert(std::make_pair(id, std::move(resource)));
+	Entry entry;
+	entry.memoryUsage = estimateMemoryUsage(*resource);
+	entry.resource = std::move(resource);
+	entry.references = 0;
+	entry.lastUse = ++mUseCounter;
+
+	// Insert and check success; a duplicate is discarded and not counted
+	auto inserted = mResourceMap.insert(std::make_pair(id, std::move(entry)));
 	assert(inserted.second);
+	if (!inserted.second)
+		return;
+
+	// Not evicted here: a freshly loaded resource is usually acquired right after
+	mMemoryUsage += inserted.first->second.memoryUsage;
+}
+
+template <typename Resource, typename Identifier>
+void ResourceHolder<Resource, Identifier>::evictUnused()
+{
+	while (mMemoryUsage > mMemoryBudget)
+	{
+		// Few resources per holder, a linear search for the least recently used one is enough
+		auto victim = mResourceMap.end();
+		for (auto itr = mResourceMap.begin(); itr != mResourceMap.end(); ++itr)
+		{
+			if (itr->second.references == 0 && (victim == mResourceMap.end() || itr->second.lastUse < victim->second.lastUse))
+				victim = itr;
+		}
+
+		// Everything left is in use
+		if (victim == mResourceMap.end())
+			return;
+
+		mMemoryUsage -= victim->second.memoryUsage;
+		mResourceMap.erase(victim);
+	}
+}
+
+template <typename Resource, typename Identifier>
+ResourceLoader::Handle ResourceHolder<Resource, Identifier>::enqueue(ResourceLoader& loader, Identifier id, const std::string& filename,
+	std::shared_ptr<ResourceDecoder<Resource>> decoder, ResourceLoader::Step decode)
+{
+	// E.g. a loading screen left and entered again before its jobs completed
+	auto pending = mPendingLoads.find(id);
+	if (pending != mPendingLoads.end())
+		return pending->second;
+
+	// Decoded resource is inserted on the thread calling ResourceLoader::update()
+	ResourceLoader::Handle handle = loader.enqueue(filename, decode, [this, id, decoder] () -> bool
+	{
+		mPendingLoads.erase(id);
+
+		std::unique_ptr<Resource> resource = decoder->finalize();
+		if (!resource)
+			return false;
+
+		insertResource(id, std::move(resource));
+		return true;
+	});
+
+	mPendingLoads[id] = handle;
+	return handle;
 }
@@ -55,6 +55,7 @@ namespace SoundEffect
 		LaunchMissile,
 		CollectPickup,
 		Button,
+		SoundEffectCount
 	};
 }
 
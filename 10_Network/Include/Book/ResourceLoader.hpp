@@ -0,0 +1,77 @@
+#ifndef BOOK_RESOURCELOADER_HPP
+#define BOOK_RESOURCELOADER_HPP
+
+#include <SFML/System/NonCopyable.hpp>
+#include <SFML/System/Thread.hpp>
+#include <SFML/System/Time.hpp>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+
+// Decodes resource files on a fixed pool of worker threads, which sleep while there is nothing to decode. The finalization step of each job
+// (GPU upload, insertion into a ResourceHolder) runs on the thread calling update().
+class ResourceLoader : private sf::NonCopyable
+{
+	public:
+		typedef std::function<bool()> Step;
+
+		// Observes a single queued job
+		class Handle
+		{
+			public:
+									Handle();
+				bool				isReady() const;
+
+			private:
+				friend class ResourceLoader;
+				std::shared_ptr<bool>	mReady;
+		};
+
+
+	public:
+		explicit					ResourceLoader(std::size_t threadCount = 0);
+									~ResourceLoader();
+
+		Handle						enqueue(const std::string& filename, Step decode, Step finalize);
+		void						update(sf::Time budget);
+
+		bool						isFinished() const;
+		float						getCompletion() const;
+
+
+	private:
+		struct Job
+		{
+			std::string				filename;
+			Step					decode;
+			Step					finalize;
+			bool					decoded;
+			std::shared_ptr<bool>	ready;
+		};
+
+
+	private:
+		void						workerThread();
+
+
+	private:
+		std::size_t								mThreadCount;
+		std::vector<std::unique_ptr<sf::Thread>>	mWorkers;
+
+		std::mutex								mMutex;
+		std::condition_variable					mJobCondition;
+		bool									mStopRequested;
+		std::deque<Job>							mPendingJobs;
+		std::deque<Job>							mDecodedJobs;
+
+		std::size_t								mQueuedCount;
+		std::size_t								mFinishedCount;
+};
+
+#endif // BOOK_RESOURCELOADER_HPP
@@ -10,6 +10,7 @@
 
 #include <vector>
 #include <set>
+#include <map>
 #include <memory>
 #include <utility>
 
@@ -17,6 +18,17 @@
 struct Command;
 class CommandQueue;
 
+// Totals over a scene graph, gathered by SceneNode::collectStatistics()
+struct SceneStatistics
+{
+										SceneStatistics();
+
+	std::size_t							nodes;
+	std::size_t							drawCalls;
+	std::size_t							particles;
+	std::map<unsigned int, std::size_t>	categories;		// Node count per getCategory() value
+};
+
 class SceneNode : public sf::Transformable, public sf::Drawable, private sf::NonCopyable
 {
 	public:
@@ -31,6 +43,7 @@ class SceneNode : public sf::Transformable, public sf::Drawable, private sf::Non
 		Ptr						detachChild(const SceneNode& node);
 		
 		void					update(sf::Time dt, CommandQueue& commands);
+		void					interpolate(float alpha);
 
 		sf::Vector2f			getWorldPosition() const;
 		sf::Transform			getWorldTransform() const;
@@ -38,13 +51,21 @@ class SceneNode : public sf::Transformable, public sf::Drawable, private sf::Non
 		void					onCommand(const Command& command, sf::Time dt);
 		virtual unsigned int	getCategory() const;
 
-		void					checkSceneCollision(SceneNode& sceneGraph, std::set<Pair>& collisionPairs);
-		void					checkNodeCollision(SceneNode& node, std::set<Pair>& collisionPairs);
+		// testCount is increased by the number of node pairs compared
+		void					checkSceneCollision(SceneNode& sceneGraph, std::set<Pair>& collisionPairs, std::size_t& testCount);
+		void					checkNodeCollision(SceneNode& node, std::set<Pair>& collisionPairs, std::size_t& testCount);
 		void					removeWrecks();
 		virtual sf::FloatRect	getBoundingRect() const;
 		virtual bool			isMarkedForRemoval() const;
 		virtual bool			isDestroyed() const;
 
+		void					collectStatistics(SceneStatistics& statistics) const;
+
+		// Floating origin: moves everything the node places in world coordinates by offset.
+		// Nodes just move; those that keep world coordinates of their own override rebase().
+		virtual void			rebase(sf::Vector2f offset);
+		void					rebaseChildren(sf::Vector2f offset);
+
 
 	private:
 		virtual void			updateCurrent(sf::Time dt, CommandQueue& commands);
@@ -55,11 +76,18 @@ class SceneNode : public sf::Transformable, public sf::Drawable, private sf::Non
 		void					drawChildren(sf::RenderTarget& target, sf::RenderStates states) const;
 		void					drawBoundingRect(sf::RenderTarget& target, sf::RenderStates states) const;
 
+		virtual void			collectCurrentStatistics(SceneStatistics& statistics) const;
+
 
 	private:
 		std::vector<Ptr>		mChildren;
 		SceneNode*				mParent;
 		Category::Type			mDefaultCategory;
+
+		sf::Vector2f			mPreviousPosition;
+		float					mPreviousRotation;
+		bool					mHasPreviousState;
+		sf::Transform			mRenderTransform;
 };
 
 bool	collision(const SceneNode& lhs, const SceneNode& rhs);
@@ -0,0 +1,50 @@
+#ifndef BOOK_SERVERCONNECTION_HPP
+#define BOOK_SERVERCONNECTION_HPP
+
+#include <SFML/System/NonCopyable.hpp>
+#include <SFML/System/Time.hpp>
+#include <SFML/Network/Packet.hpp>
+
+
+// Client side of the connection to a GameServer, either over the network (RemoteConnection)
+// or in-process for the hosting client (LocalConnection). Used from the game thread only.
+class ServerConnection : private sf::NonCopyable
+{
+	public:
+		enum Status
+		{
+			Resolving,
+			Connecting,
+			Connected,
+			Disconnected
+		};
+
+		struct Message
+		{
+			sf::Int32				type;
+			sf::Packet				packet;			// Read position is past the type
+			sf::Time				arrivalTime;	// Taken when the message arrived, see now()
+		};
+
+
+	public:
+		virtual						~ServerConnection();
+
+		virtual Status				getStatus() const = 0;
+		virtual sf::Time			now() const = 0;
+
+		// Valid once connected
+		virtual sf::Time			getResolveTime() const = 0;
+		virtual sf::Time			getConnectTime() const = 0;
+		virtual std::size_t			getConnectAttempts() const = 0;
+
+		virtual bool				send(const sf::Packet& packet) = 0;
+		virtual bool				pollMessage(Message& message) = 0;
+		virtual std::size_t			getPendingMessageCount() const = 0;
+
+		// Traffic since the connection was created, including packet framing where there is any
+		virtual std::size_t			getBytesReceived() const = 0;
+		virtual std::size_t			getBytesSent() const = 0;
+};
+
+#endif // BOOK_SERVERCONNECTION_HPP
@@ -0,0 +1,69 @@
+#ifndef BOOK_SOFTWAREBLOOMEFFECT_HPP
+#define BOOK_SOFTWAREBLOOMEFFECT_HPP
+
+#include <Book/PostEffect.hpp>
+#include <Book/WorkerGroup.hpp>
+
+#include <SFML/Config.hpp>
+#include <SFML/System/Vector2.hpp>
+#include <SFML/Graphics/Texture.hpp>
+
+#include <vector>
+
+
+namespace sf
+{
+	class Image;
+}
+
+// CPU implementation of BloomEffect, for targets without shader support.
+// Runs the same passes as the GLSL version on RGBA buffers, using SSE2 where available and a WorkerGroup for row bands.
+class SoftwareBloomEffect : public PostEffect
+{
+	public:
+		explicit			SoftwareBloomEffect(std::size_t threadCount = 0);
+
+		virtual void		apply(const sf::RenderTexture& input, sf::RenderTarget& output);
+		void				apply(const sf::Image& input, sf::Image& output);
+
+
+	public:
+		// Floating point RGBA image, 4 floats per pixel
+		struct Buffer
+		{
+								Buffer();
+			void				resize(unsigned int width, unsigned int height);
+
+			std::vector<float>	pixels;
+			unsigned int		width;
+			unsigned int		height;
+		};
+
+
+	private:
+		void				process(const sf::Uint8* input, sf::Vector2u size);
+		void				prepareBuffers(sf::Vector2u size);
+
+		void				filterBright(const sf::Uint8* input);
+		void				blurMultipass(Buffer& first, Buffer& second);
+		void				blur(const Buffer& input, Buffer& output, int dx, int dy);
+		void				downsample(const Buffer& input, Buffer& output);
+		void				add(const Buffer& source, const Buffer& bloom, Buffer& output);
+		void				addFinal(const sf::Uint8* source, const Buffer& bloom);
+
+		void				convertBloom(const Buffer& bloom);
+
+
+	private:
+		WorkerGroup				mWorkers;
+		sf::Vector2u			mSize;
+
+		Buffer					mBrightness;
+		Buffer					mFirstPass[2];
+		Buffer					mSecondPass[2];
+		std::vector<sf::Uint8>	mResult;		// Final image, or the bloom alone when the GPU adds it
+
+		sf::Texture				mOutputTexture;
+};
+
+#endif // BOOK_SOFTWAREBLOOMEFFECT_HPP
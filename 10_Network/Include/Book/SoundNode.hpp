@@ -4,20 +4,55 @@
 #include <Book/SceneNode.hpp>
 #include <Book/ResourceIdentifiers.hpp>
 
+#include <vector>
+
 
 class SoundPlayer;
 
+// Collects sound requests during a frame and plays them in updateCurrent(). Requests for the same
+// effect close in time and space are merged into one voice, which is played louder. A voice of an effect
+// plays at most once per window in an area; requests arriving meanwhile are merged into the next one.
 class SoundNode : public SceneNode
 {
 	public:
 		explicit				SoundNode(SoundPlayer& player);
 		void					playSound(SoundEffect::ID sound, sf::Vector2f position);
+		void					setCoalescing(sf::Time window, float distance);
 
 		virtual unsigned int	getCategory() const;
 
 
+	private:
+		virtual void			updateCurrent(sf::Time dt, CommandQueue& commands);
+
+
+	private:
+		struct Request
+		{
+			SoundEffect::ID		effect;
+			sf::Vector2f		position;
+		};
+
+		struct Group
+		{
+			SoundEffect::ID		effect;
+			sf::Vector2f		position;
+			std::size_t			count;
+			sf::Time			age;
+			bool				played;
+		};
+
+
+	private:
+		bool					isNearby(const Group& group, SoundEffect::ID effect, sf::Vector2f position) const;
+
+
 	private:
 		SoundPlayer&			mSounds;
+		std::vector<Request>	mRequests;
+		std::vector<Group>		mGroups;
+		sf::Time				mWindow;
+		float					mDistance;
 };
 
 #endif // BOOK_SOUNDNODE_HPP
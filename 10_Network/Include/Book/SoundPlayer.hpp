@@ -9,25 +9,52 @@
 #include <SFML/Audio/SoundBuffer.hpp>
 #include <SFML/Audio/Sound.hpp>
 
-#include <list>
+#include <vector>
 
 
+// Plays sound effects on a fixed pool of voices. Effects have a priority and a concurrency cap;
+// distant effects are culled, and when no voice is free the least important one is stolen.
 class SoundPlayer : private sf::NonCopyable
 {
 	public:
-									SoundPlayer();
+									SoundPlayer(ResourceLoader& loader, const AssetArchive& archive);
 
 		void						play(SoundEffect::ID effect);
-		void						play(SoundEffect::ID effect, sf::Vector2f position);
+		// Volumes above 100 can't raise the gain, they widen the radius heard at full volume
+		void						play(SoundEffect::ID effect, sf::Vector2f position, float volume = 100.f);
 
-		void						removeStoppedSounds();
 		void						setListenerPosition(sf::Vector2f position);
 		sf::Vector2f				getListenerPosition() const;
 
+		std::size_t					getActiveVoiceCount() const;
+		std::size_t					getVoiceCount() const;
+		std::size_t					getStolenVoiceCount() const;
+		std::size_t					getCulledSoundCount() const;
+
+
+	private:
+		struct Voice
+		{
+			sf::Sound				sound;
+			SoundEffect::ID			effect;
+			int						priority;
+			float					gain;
+			std::size_t				sequence;
+		};
+
+
+	private:
+		Voice*						findVoice(SoundEffect::ID effect, int priority, float gain);
+		float						computeGain(sf::Vector2f position) const;
+
 
 	private:
 		SoundBufferHolder			mSoundBuffers;
-		std::list<sf::Sound>		mSounds;
+		std::vector<Voice>			mVoices;
+		std::size_t					mSequence;
+
+		std::size_t					mStolenVoices;
+		std::size_t					mCulledSounds;
 };
 
 #endif // BOOK_SOUNDPLAYER_HPP
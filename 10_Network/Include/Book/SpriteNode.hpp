@@ -15,6 +15,7 @@ class SpriteNode : public SceneNode
 
 	private:
 		virtual void		drawCurrent(sf::RenderTarget& target, sf::RenderStates states) const;
+		virtual void		collectCurrentStatistics(SceneStatistics& statistics) const;
 
 
 	private:
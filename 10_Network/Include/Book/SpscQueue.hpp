@@ -0,0 +1,50 @@
+#ifndef BOOK_SPSCQUEUE_HPP
+#define BOOK_SPSCQUEUE_HPP
+
+#include <SFML/System/NonCopyable.hpp>
+
+#include <atomic>
+#include <vector>
+
+
+// Bounded lock-free queue for exactly one producer thread and one consumer thread.
+// Slots are reused, so elements keep their allocations between round trips.
+template <typename T>
+class SpscQueue : private sf::NonCopyable
+{
+	public:
+		// Capacity is rounded up to a power of two
+		explicit					SpscQueue(std::size_t capacity);
+
+		// Producer side; returns false if the queue is full
+		bool						push(const T& value);
+
+		// Consumer side; returns false if the queue is empty
+		bool						pop(T& value);
+
+		// Exact from either side when the other one is idle, approximate otherwise
+		std::size_t					size() const;
+		std::size_t					capacity() const;
+
+
+	private:
+		// Keeps the producer's and consumer's indices on different cache lines
+		struct CacheLinePadding
+		{
+			char					bytes[64];
+		};
+
+
+	private:
+		std::vector<T>				mSlots;
+		std::size_t					mMask;
+
+		CacheLinePadding			mPadding0;
+		std::atomic<std::size_t>	mHead;		// Next slot to read, written by the consumer
+		CacheLinePadding			mPadding1;
+		std::atomic<std::size_t>	mTail;		// Next slot to write, written by the producer
+		CacheLinePadding			mPadding2;
+};
+
+#include "SpscQueue.inl"
+#endif // BOOK_SPSCQUEUE_HPP
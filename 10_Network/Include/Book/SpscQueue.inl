@@ -0,0 +1,57 @@
+
+template <typename T>
+SpscQueue<T>::SpscQueue(std::size_t capacity)
+: mSlots()
+, mMask(0)
+, mHead(0)
+, mTail(0)
+{
+	std::size_t size = 1;
+	while (size < capacity)
+		size *= 2;
+
+	mSlots.resize(size);
+	mMask = size - 1;
+}
+
+template <typename T>
+bool SpscQueue<T>::push(const T& value)
+{
+	std::size_t tail = mTail.load(std::memory_order_relaxed);
+	if (tail - mHead.load(std::memory_order_acquire) == mSlots.size())
+		return false;
+
+	mSlots[tail & mMask] = value;
+
+	// Publishes the slot's contents to the consumer
+	mTail.store(tail + 1, std::memory_order_release);
+	return true;
+}
+
+template <typename T>
+bool SpscQueue<T>::pop(T& value)
+{
+	std::size_t head = mHead.load(std::memory_order_relaxed);
+	if (head == mTail.load(std::memory_order_acquire))
+		return false;
+
+	value = mSlots[head & mMask];
+
+	// Hands the slot back to the producer
+	mHead.store(head + 1, std::memory_order_release);
+	return true;
+}
+
+template <typename T>
+std::size_t SpscQueue<T>::size() const
+{
+	// Head first: the tail never falls behind it afterwards
+	std::size_t head = mHead.load(std::memory_order_acquire);
+	return mTail.load(std::memory_order_acquire) - head;
+}
+
+template <typename T>
+std::size_t SpscQueue<T>::capacity() const
+{
+	return mSlots.size();
+}
@@ -19,6 +19,8 @@ class StateStack;
 class MusicPlayer;
 class SoundPlayer;
 class KeyBinding;
+class Statistics;
+class ResourceLoader;
 
 class State
 {
@@ -27,16 +29,21 @@ class State
 
 		struct Context
 		{
-								Context(sf::RenderWindow& window, TextureHolder& textures, FontHolder& fonts,
-									MusicPlayer& music, SoundPlayer& sounds, KeyBinding& keys1, KeyBinding& keys2);
+								Context(sf::RenderWindow& window, TextureHolder& textures, FontHolder& fonts, ShaderHolder& shaders,
+									MusicPlayer& music, SoundPlayer& sounds, KeyBinding& keys1, KeyBinding& keys2,
+									Statistics& statistics, ResourceLoader& loader, float minResolutionScale);
 
 			sf::RenderWindow*	window;
 			TextureHolder*		textures;
 			FontHolder*			fonts;
+			ShaderHolder*		shaders;
 			MusicPlayer*		music;
 			SoundPlayer*		sounds;
 			KeyBinding*			keys1;
 			KeyBinding*			keys2;
+			Statistics*			statistics;
+			ResourceLoader*		loader;
+			float				minResolutionScale;
 		};
 
 
@@ -50,6 +57,7 @@ class State
 
 		virtual void		onActivate();
 		virtual void		onDestroy();
+		virtual void		setInterpolation(float alpha);
 
 
 	protected:
@@ -10,7 +10,11 @@ namespace States
 		Title,
 		Menu,
 		Game,
+		EndlessGame,
 		Loading,
+		LoadingEndlessGame,
+		LoadingHostGame,
+		LoadingJoinGame,
 		Pause,
 		NetworkPause,
 		Settings,
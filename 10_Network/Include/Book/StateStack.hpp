@@ -42,6 +42,7 @@ class StateStack : private sf::NonCopyable
 		void				update(sf::Time dt);
 		void				draw();
 		void				handleEvent(const sf::Event& event);
+		void				setInterpolation(float alpha);
 
 		void				pushState(States::ID stateID);
 		void				popState();
@@ -72,6 +73,9 @@ class StateStack : private sf::NonCopyable
 
 		State::Context										mContext;
 		std::map<States::ID, std::function<State::Ptr()>>	mFactories;
+
+		// Index of the lowest state that the last update() reached
+		std::size_t											mFirstUpdated;
 };
 
 
@@ -0,0 +1,25 @@
+#ifndef BOOK_STATISTICS_HPP
+#define BOOK_STATISTICS_HPP
+
+#include <SFML/System/NonCopyable.hpp>
+
+#include <map>
+#include <string>
+
+
+// Named values reported by subsystems, displayed by the application's statistics overlay
+class Statistics : private sf::NonCopyable
+{
+	public:
+								Statistics();
+
+		void					setValue(const std::string& name, const std::string& value);
+		void					removeValue(const std::string& name);
+		std::string				getText() const;
+
+
+	private:
+		std::map<std::string, std::string>	mValues;
+};
+
+#endif // BOOK_STATISTICS_HPP
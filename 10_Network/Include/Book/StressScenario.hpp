@@ -0,0 +1,39 @@
+#ifndef BOOK_STRESSSCENARIO_HPP
+#define BOOK_STRESSSCENARIO_HPP
+
+#include <Book/Aircraft.hpp>
+#include <Book/Projectile.hpp>
+#include <Book/Particle.hpp>
+
+#include <SFML/System/Time.hpp>
+
+#include <array>
+#include <string>
+
+
+// Entity densities that World keeps up within the battlefield during a stress run,
+// read from a text file. See Media/Scenarios for the format.
+struct StressScenario
+{
+	struct Population
+	{
+												Population();
+
+		std::array<std::size_t, Aircraft::TypeCount>		enemies;
+		std::array<std::size_t, Projectile::TypeCount>		projectiles;
+		std::size_t											pickups;
+		std::array<std::size_t, Particle::ParticleCount>	emitters;
+	};
+
+										StressScenario();
+
+	// Throws std::runtime_error on a missing file or malformed line
+	void								loadFromFile(const std::string& filename);
+
+	std::string							name;
+	sf::Time							duration;
+	unsigned int						seed;
+	Population							population;
+};
+
+#endif // BOOK_STRESSSCENARIO_HPP
@@ -19,6 +19,7 @@ class TextNode : public SceneNode
 
 	private:
 		virtual void		drawCurrent(sf::RenderTarget& target, sf::RenderStates states) const;
+		virtual void		collectCurrentStatistics(SceneStatistics& statistics) const;
 
 
 	private:
@@ -0,0 +1,39 @@
+#ifndef BOOK_WAVEGENERATOR_HPP
+#define BOOK_WAVEGENERATOR_HPP
+
+#include <Book/Level.hpp>
+
+#include <random>
+#include <vector>
+
+
+// Enemy waves for the endless mode: formations of growing size and strength, generated one at a time.
+// The same seed always produces the same sequence of waves.
+class WaveGenerator
+{
+	public:
+		// Formations stay within maxOffsetX of the horizontal center
+								WaveGenerator(unsigned int seed, float maxOffsetX);
+
+		// Appends the next wave, with distances measured from the wave's start.
+		// Returns the distance from this wave's start to the next one's.
+		float					generate(std::vector<Level::Spawn>& spawns);
+
+
+	private:
+		enum Formation
+		{
+			Line,
+			Column,
+			Wedge,
+			FormationCount
+		};
+
+
+	private:
+		std::default_random_engine	mRandom;
+		float						mMaxOffsetX;
+		std::size_t					mWaveCount;
+};
+
+#endif // BOOK_WAVEGENERATOR_HPP
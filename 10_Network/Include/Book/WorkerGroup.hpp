@@ -0,0 +1,56 @@
+#ifndef BOOK_WORKERGROUP_HPP
+#define BOOK_WORKERGROUP_HPP
+
+#include <SFML/System/NonCopyable.hpp>
+#include <SFML/System/Thread.hpp>
+
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+
+// Fixed set of threads that split a range of rows into bands and process them together with the calling thread.
+// The threads are started once and sleep between calls to run().
+class WorkerGroup : private sf::NonCopyable
+{
+	public:
+		typedef std::function<void(unsigned int, unsigned int)> Task;
+
+
+	public:
+		// 0 means one thread per hardware core, the calling thread included
+		explicit					WorkerGroup(std::size_t threadCount = 0);
+									~WorkerGroup();
+
+		// Calls task(begin, end) for bands of at least minRowsPerBand rows; returns when all bands are done
+		void						run(unsigned int rows, unsigned int minRowsPerBand, const Task& task);
+
+		std::size_t					getThreadCount() const;
+
+
+	private:
+		void						workerThread(std::size_t band);
+		void						runBand(std::size_t band);
+
+
+	private:
+		std::size_t								mThreadCount;
+		std::vector<std::unique_ptr<sf::Thread>>	mWorkers;
+
+		std::mutex								mMutex;
+		std::condition_variable					mStartCondition;
+		std::condition_variable					mDoneCondition;
+
+		// Current run, written by the calling thread while the workers wait
+		const Task*								mTask;
+		unsigned int							mRows;
+		unsigned int							mBandSize;
+		std::size_t								mBandCount;
+		std::size_t								mGeneration;
+		std::size_t								mPendingBands;
+		bool									mStopRequested;
+};
+
+#endif // BOOK_WORKERGROUP_HPP
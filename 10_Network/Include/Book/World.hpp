@@ -9,16 +9,24 @@
 #include <Book/CommandQueue.hpp>
 #include <Book/Command.hpp>
 #include <Book/Pickup.hpp>
-#include <Book/BloomEffect.hpp>
+#include <Book/RenderTargetPool.hpp>
+#include <Book/PostEffectChain.hpp>
+#include <Book/ResolutionScaler.hpp>
 #include <Book/SoundPlayer.hpp>
 #include <Book/NetworkProtocol.hpp>
+#include <Book/StressScenario.hpp>
+#include <Book/Level.hpp>
+#include <Book/WaveGenerator.hpp>
 
 #include <SFML/System/NonCopyable.hpp>
+#include <SFML/System/Clock.hpp>
 #include <SFML/Graphics/View.hpp>
 #include <SFML/Graphics/Texture.hpp>
 
 #include <array>
 #include <queue>
+#include <random>
+#include <memory>
 
 
 // Forward declaration
@@ -28,13 +36,41 @@ namespace sf
 }
 
 class NetworkNode;
+class BackgroundNode;
+class ResourceLoader;
+class Statistics;
 
 class World : private sf::NonCopyable
 {
 	public:
-											World(sf::RenderTarget& outputTarget, FontHolder& fonts, SoundPlayer& sounds, bool networked = false);
+		// Parts of update() and draw(), timed on every frame
+		enum Phase
+		{
+			CommandPhase,
+			CollisionPhase,
+			RemoveWrecksPhase,
+			SpawnPhase,
+			GraphUpdatePhase,
+			SoundPhase,
+			DrawScenePhase,
+			PostEffectPhase,
+			PhaseCount
+		};
+
+
+	public:
+											World(sf::RenderTarget& outputTarget, TextureHolder& textures, ShaderHolder& shaders,
+												FontHolder& fonts, SoundPlayer& sounds, Statistics& statistics, bool networked = false);
+											~World();
+
+		static void							loadResources(ResourceLoader& loader, TextureHolder& textures, ShaderHolder& shaders);
+
 		void								update(sf::Time dt);
 		void								draw();
+		void								setInterpolation(float alpha);
+
+		// Lowest fraction of the output resolution the scene is rendered at when rendering is too slow
+		void								setMinResolutionScale(float minScale);
 
 		sf::FloatRect						getViewBounds() const;		
 		CommandQueue&						getCommandQueue();
@@ -43,8 +79,8 @@ class World : private sf::NonCopyable
 		void								setCurrentBattleFieldPosition(float lineY);
 		void								setWorldHeight(float height);
 
+		// Spawns added at runtime, e.g. by the server; the level's own spawns are streamed from its file
 		void								addEnemy(Aircraft::Type type, float relX, float relY);
-		void								sortEnemies();
 
 		bool 								hasAlivePlayer() const;
 		bool 								hasPlayerReachedEnd() const;
@@ -52,14 +88,23 @@ class World : private sf::NonCopyable
 		void								setWorldScrollCompensation(float compensation);
 
 		Aircraft*							getAircraft(int identifier) const;
+		Handle								getAircraftHandle(int identifier) const;
 		sf::FloatRect						getBattlefieldBounds() const;
 
 		void								createPickup(sf::Vector2f position, Pickup::Type type);
 		bool								pollGameAction(GameActions::Action& out);
 
+		// Replaces the level's enemies with the scenario's population, kept up from then on. Call once.
+		void								setStressScenario(const StressScenario& scenario);
+
+		// Replaces the level with waves generated from the seed, without end. Call once.
+		void								setEndlessMode(unsigned int seed);
+
+		// Time spent in the phase during the last update() or draw()
+		sf::Time							getPhaseTime(Phase phase) const;
+
 
 	private:
-		void								loadTextures();
 		void								adaptPlayerPosition();
 		void								adaptPlayerVelocity();
 		void								handleCollisions();
@@ -68,8 +113,16 @@ class World : private sf::NonCopyable
 		void								buildScene();
 		void								addEnemies();
 		void								spawnEnemies();
+		void								spawnEnemy(Aircraft::Type type, float x, float y);
+		void								generateWaves();
+		void								updateFloatingOrigin();
+		void								rebase(sf::Vector2f offset);
+		void								maintainStressScenario();
+		sf::Vector2f						getRandomBattlefieldPosition();
 		void								destroyEntitiesOutsideView();
 		void								guideMissiles();
+		void								updateResolutionScale(sf::Time renderTime);
+		void								updateStatistics();
 
 
 	private:
@@ -90,6 +143,12 @@ class World : private sf::NonCopyable
 			{
 			}
 
+			// Lowest spawn (largest y) first in a priority queue
+			bool operator< (const SpawnPoint& rhs) const
+			{
+				return y < rhs.y;
+			}
+
 			Aircraft::Type type;
 			float x;
 			float y;
@@ -98,11 +157,13 @@ class World : private sf::NonCopyable
 
 	private:
 		sf::RenderTarget&					mTarget;
-		sf::RenderTexture					mSceneTexture;
 		sf::View							mWorldView;
-		TextureHolder						mTextures;
+		sf::Vector2f						mPreviousViewCenter;
+		float								mInterpolation;
+		TextureHolder&						mTextures;
 		FontHolder&							mFonts;
 		SoundPlayer&						mSounds;
+		Statistics&							mStatistics;
 
 		SceneNode							mSceneGraph;
 		std::array<SceneNode*, LayerCount>	mSceneLayers;
@@ -110,18 +171,44 @@ class World : private sf::NonCopyable
 
 		sf::FloatRect						mWorldBounds;
 		sf::Vector2f						mSpawnPosition;
+		const float							mOriginY;		// View center the floating origin returns to, never rebased
 		float								mScrollSpeed;
 		float								mScrollSpeedCompensation;
 		std::vector<Aircraft*>				mPlayerAircrafts;
+		HandleTable<Aircraft>				mAircraftTable;
+		std::vector<Handle>					mAircraftHandles;		// Indexed by network identifier
 
-		std::vector<SpawnPoint>				mEnemySpawnPoints;
+		Level								mLevel;
+		std::size_t							mNextLevelSpawn;
+		std::priority_queue<SpawnPoint>		mEnemySpawnPoints;
 		std::vector<Aircraft*>				mActiveEnemies;
 
-		BloomEffect							mBloomEffect;
+		RenderTargetPool					mRenderTargets;
+		PostEffectChain						mPostEffects;
+		ResolutionScaler					mResolutionScaler;
+		std::size_t							mFramesSinceGpuSample;
+
+		// Counted during the last update, published by updateStatistics()
+		std::size_t							mCommandsDispatched;
+		std::size_t							mCollisionTests;
+		std::size_t							mCollisionsFound;
+		sf::Clock							mStatisticsClock;
+		std::array<sf::Time, PhaseCount>	mPhaseTimes;
+
+		// Stress run: target population, and the population counted during the last update
+		std::unique_ptr<StressScenario>		mStressScenario;
+		StressScenario::Population			mStressPopulation;
+		SceneNode*							mStressEmitterLayer;
+		std::default_random_engine			mStressRandom;
+
+		// Endless mode: waves are generated when the battlefield reaches mNextWaveY
+		std::unique_ptr<WaveGenerator>		mWaveGenerator;
+		float								mNextWaveY;
 
 		bool								mNetworkedWorld;
 		NetworkNode*						mNetworkNode;
 		SpriteNode*							mFinishSprite;
+		BackgroundNode*						mBackground;
 };
 
 #endif // BOOK_WORLD_HPP
@@ -101,6 +101,12 @@ void Aircraft::drawCurrent(sf::RenderTarget& target, sf::RenderStates states) co
 		target.draw(mSprite, states);
 }
 
+void Aircraft::collectCurrentStatistics(SceneStatistics& statistics) const
+{
+	// Sprite or explosion; the health and missile displays are child nodes
+	++statistics.drawCalls;
+}
+
 void Aircraft::disablePickups()
 {
 	mPickupsEnabled = false;
@@ -153,6 +159,11 @@ void Aircraft::updateCurrent(sf::Time dt, CommandQueue& commands)
 	Entity::updateCurrent(dt, commands);
 }
 
+Aircraft::Type Aircraft::getType() const
+{
+	return mType;
+}
+
 unsigned int Aircraft::getCategory() const
 {
 	if (isAllied())
@@ -1,5 +1,6 @@
 #include <Book/Application.hpp>
 #include <Book/Utility.hpp>
+#include <Book/Profiler.hpp>
 #include <Book/State.hpp>
 #include <Book/StateIdentifiers.hpp>
 #include <Book/TitleState.hpp>
@@ -9,35 +10,59 @@
 #include <Book/PauseState.hpp>
 #include <Book/SettingsState.hpp>
 #include <Book/GameOverState.hpp>
+#include <Book/LoadingState.hpp>
 
 
 const sf::Time Application::TimePerFrame = sf::seconds(1.f/60.f);
+const sf::Time Application::LoadingTimePerFrame = sf::milliseconds(4);
+const std::size_t Application::TextureMemoryBudget = 64 * 1024 * 1024;
+const float Application::MinResolutionScale = 0.5f;
 
 Application::Application()
 : mWindow(sf::VideoMode(1024, 768), "Network", sf::Style::Close)
+, mArchive("Media.pak")
+, mLoader()
 , mTextures()
 , mFonts()
-, mMusic()
-, mSounds()
+, mShaders()
+, mMusic(mLoader, mArchive)
+, mSounds(mLoader, mArchive)
+, mStatistics()
 , mKeyBinding1(1)
 , mKeyBinding2(2)
-, mStateStack(State::Context(mWindow, mTextures, mFonts, mMusic, mSounds, mKeyBinding1, mKeyBinding2))
+, mStateStack(State::Context(mWindow, mTextures, mFonts, mShaders, mMusic, mSounds, mKeyBinding1, mKeyBinding2, mStatistics, mLoader, MinResolutionScale))
 , mStatisticsText()
 , mStatisticsUpdateTime()
 , mStatisticsNumFrames(0)
+, mOverlay(mStatistics)
+, mUpdateTime()
+, mRenderTime()
 {
+	Profiler::setThreadName("Main");
+
 	mWindow.setKeyRepeatEnabled(false);
 	mWindow.setVerticalSyncEnabled(true);
 
+	mTextures.setArchive(mArchive);
+	mFonts.setArchive(mArchive);
+	mShaders.setArchive(mArchive);
+
 	mFonts.load(Fonts::Main, 	"Media/Sansation.ttf");
 
 	mTextures.load(Textures::TitleScreen,	"Media/Textures/TitleScreen.png");
 	mTextures.load(Textures::Buttons,		"Media/Textures/Buttons.png");
 
+	// Menu textures are used throughout, never evict them
+	mTextures.acquire(Textures::TitleScreen);
+	mTextures.acquire(Textures::Buttons);
+	mTextures.setMemoryBudget(TextureMemoryBudget);
+
 	mStatisticsText.setFont(mFonts.get(Fonts::Main));
 	mStatisticsText.setPosition(5.f, 5.f);
 	mStatisticsText.setCharacterSize(10u);
 
+	mOverlay.setFont(mFonts.get(Fonts::Main));
+
 	registerStates();
 	mStateStack.pushState(States::Title);
 
@@ -53,6 +78,11 @@ void Application::run()
 	{
 		sf::Time dt = clock.restart();
 		timeSinceLastUpdate += dt;
+
+		// dt covers the previous frame, whose update and render times were measured below
+		mOverlay.addFrame(dt, mUpdateTime, mRenderTime);
+
+		sf::Clock updateClock;
 		while (timeSinceLastUpdate > TimePerFrame)
 		{
 			timeSinceLastUpdate -= TimePerFrame;
@@ -64,6 +94,13 @@ void Application::run()
 			if (mStateStack.isEmpty())
 				mWindow.close();
 		}
+		mUpdateTime = updateClock.getElapsedTime();
+
+		// Upload resources decoded in the background, without stalling the frame
+		mLoader.update(LoadingTimePerFrame);
+
+		// Render between the last two simulation steps, using the time left in the accumulator
+		mStateStack.setInterpolation(timeSinceLastUpdate.asSeconds() / TimePerFrame.asSeconds());
 
 		updateStatistics(dt);
 		render();
@@ -72,6 +109,8 @@ void Application::run()
 
 void Application::processInput()
 {
+	BOOK_PROFILE_ZONE("Application::processInput");
+
 	sf::Event event;
 	while (mWindow.pollEvent(event))
 	{
@@ -79,23 +118,44 @@ void Application::processInput()
 
 		if (event.type == sf::Event::Closed)
 			mWindow.close();
+
+		if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::F3)
+			mOverlay.setVisible(!mOverlay.isVisible());
+
+#ifdef BOOK_ENABLE_PROFILER
+		if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::F5)
+			toggleProfilerCapture();
+#endif
 	}
 }
 
 void Application::update(sf::Time dt)
 {
+	BOOK_PROFILE_ZONE("Application::update");
+
 	mStateStack.update(dt);
+	mMusic.update(dt);
 }
 
 void Application::render()
 {
+	BOOK_PROFILE_ZONE("Application::render");
+
+	sf::Clock renderClock;
+
 	mWindow.clear();
 
 	mStateStack.draw();
 
+	// F3 switches between the plain statistics and the overlay, which includes them
 	mWindow.setView(mWindow.getDefaultView());
-	mWindow.draw(mStatisticsText);
+	if (mOverlay.isVisible())
+		mWindow.draw(mOverlay);
+	else
+		mWindow.draw(mStatisticsText);
 
+	// Waiting for the vertical sync is not render work
+	mRenderTime = renderClock.getElapsedTime();
 	mWindow.display();
 }
 
@@ -105,18 +165,44 @@ void Application::updateStatistics(sf::Time dt)
 	mStatisticsNumFrames += 1;
 	if (mStatisticsUpdateTime >= sf::seconds(1.0f))
 	{
-		mStatisticsText.setString("FPS: " + toString(mStatisticsNumFrames));
+		mStatistics.setValue("Textures", toString(mTextures.getResourceCount()) + " loaded, "
+			+ toString(mTextures.getMemoryUsage() / 1024) + " / " + toString(mTextures.getMemoryBudget() / 1024) + " KB");
+
+		mStatistics.setValue("Sounds", toString(mSounds.getActiveVoiceCount()) + " / " + toString(mSounds.getVoiceCount()) + " voices, "
+			+ toString(mSounds.getStolenVoiceCount()) + " stolen, " + toString(mSounds.getCulledSoundCount()) + " culled");
+
+		mStatisticsText.setString("FPS: " + toString(mStatisticsNumFrames) + "\n" + mStatistics.getText());
 
 		mStatisticsUpdateTime -= sf::seconds(1.0f);
 		mStatisticsNumFrames = 0;
 	}
 }
 
+void Application::toggleProfilerCapture()
+{
+	// F5 starts a capture, pressing it again writes the trace
+	if (!Profiler::isCapturing())
+	{
+		Profiler::startCapture();
+		mStatistics.setValue("Profiler", "capturing, F5 to save");
+	}
+	else
+	{
+		Profiler::stopCapture();
+		mStatistics.setValue("Profiler", Profiler::exportChromeTrace("Profile.json") ? "saved Profile.json" : "could not write Profile.json");
+	}
+}
+
 void Application::registerStates()
 {
 	mStateStack.registerState<TitleState>(States::Title);
 	mStateStack.registerState<MenuState>(States::Menu);
+	mStateStack.registerState<LoadingState>(States::Loading, States::Game);
+	mStateStack.registerState<LoadingState>(States::LoadingEndlessGame, States::EndlessGame);
+	mStateStack.registerState<LoadingState>(States::LoadingHostGame, States::HostGame);
+	mStateStack.registerState<LoadingState>(States::LoadingJoinGame, States::JoinGame);
 	mStateStack.registerState<GameState>(States::Game);
+	mStateStack.registerState<GameState>(States::EndlessGame, true);
 	mStateStack.registerState<MultiplayerGameState>(States::HostGame, true);
 	mStateStack.registerState<MultiplayerGameState>(States::JoinGame, false);
 	mStateStack.registerState<PauseState>(States::Pause);
@@ -0,0 +1,163 @@
+#include <Book/AssetArchive.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+
+namespace
+{
+	const char Magic[4] = { 'B', 'P', 'A', 'K' };
+	const std::size_t HeaderSize = 16;
+	const std::size_t IndexEntrySize = 24;
+
+	sf::Uint64 readInteger(const char* data, std::size_t bytes)
+	{
+		sf::Uint64 value = 0;
+		for (std::size_t i = 0; i < bytes; ++i)
+			value |= static_cast<sf::Uint64>(static_cast<unsigned char>(data[i])) << (8 * i);
+
+		return value;
+	}
+
+	void writeInteger(std::ostream& stream, sf::Uint64 value, std::size_t bytes)
+	{
+		for (std::size_t i = 0; i < bytes; ++i)
+			stream.put(static_cast<char>((value >> (8 * i)) & 0xff));
+	}
+
+	std::size_t alignOffset(std::size_t offset)
+	{
+		return (offset + AssetArchive::Alignment - 1) / AssetArchive::Alignment * AssetArchive::Alignment;
+	}
+}
+
+AssetArchive::AssetArchive(const std::string& filename)
+: mFile()
+, mEntries()
+{
+	// A missing archive is not an error, resources are then loaded from loose files
+	if (mFile.open(filename) && !readIndex())
+	{
+		std::cerr << "AssetArchive - Ignoring corrupt archive " << filename << std::endl;
+		mFile.close();
+		mEntries.clear();
+	}
+}
+
+AssetArchive::~AssetArchive()
+{
+}
+
+bool AssetArchive::isOpen() const
+{
+	return mFile.isOpen();
+}
+
+const AssetArchive::Entry* AssetArchive::find(const std::string& name) const
+{
+	auto found = mEntries.find(name);
+	if (found == mEntries.end())
+		return nullptr;
+
+	return &found->second;
+}
+
+bool AssetArchive::pack(const std::string& filename, const std::vector<std::string>& inputFiles)
+{
+	// Names use forward slashes, so lookups match the paths used in code
+	std::vector<std::string> names(inputFiles);
+	for (std::size_t i = 0; i < names.size(); ++i)
+		std::replace(names[i].begin(), names[i].end(), '\\', '/');
+
+	std::vector<std::string> contents(inputFiles.size());
+	for (std::size_t i = 0; i < inputFiles.size(); ++i)
+	{
+		std::ifstream input(inputFiles[i].c_str(), std::ios::in | std::ios::binary);
+		if (!input)
+		{
+			std::cerr << "AssetArchive::pack - Failed to read " << inputFiles[i] << std::endl;
+			return false;
+		}
+
+		contents[i].assign(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+	}
+
+	// Compute data offsets behind the index
+	std::size_t offset = HeaderSize;
+	for (std::size_t i = 0; i < names.size(); ++i)
+		offset += IndexEntrySize + names[i].size();
+
+	std::vector<std::size_t> offsets(names.size());
+	for (std::size_t i = 0; i < names.size(); ++i)
+	{
+		offsets[i] = alignOffset(offset);
+		offset = offsets[i] + contents[i].size();
+	}
+
+	std::ofstream output(filename.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!output)
+		return false;
+
+	output.write(Magic, sizeof(Magic));
+	writeInteger(output, Version, 4);
+	writeInteger(output, names.size(), 4);
+	writeInteger(output, 0, 4);
+
+	for (std::size_t i = 0; i < names.size(); ++i)
+	{
+		writeInteger(output, names[i].size(), 4);
+		writeInteger(output, 0, 4);
+		writeInteger(output, offsets[i], 8);
+		writeInteger(output, contents[i].size(), 8);
+		output.write(names[i].data(), names[i].size());
+	}
+
+	for (std::size_t i = 0; i < names.size(); ++i)
+	{
+		while (static_cast<std::size_t>(output.tellp()) < offsets[i])
+			output.put('\0');
+
+		output.write(contents[i].data(), contents[i].size());
+	}
+
+	return output.good();
+}
+
+bool AssetArchive::readIndex()
+{
+	const char* data = mFile.getData();
+	std::size_t fileSize = mFile.getSize();
+
+	if (fileSize < HeaderSize || std::memcmp(data, Magic, sizeof(Magic)) != 0 || readInteger(data + 4, 4) != Version)
+		return false;
+
+	std::size_t entryCount = static_cast<std::size_t>(readInteger(data + 8, 4));
+	std::size_t position = HeaderSize;
+
+	// Entries point into the mapping, nothing is copied
+	for (std::size_t i = 0; i < entryCount; ++i)
+	{
+		if (position + IndexEntrySize > fileSize)
+			return false;
+
+		std::size_t nameLength = static_cast<std::size_t>(readInteger(data + position, 4));
+		sf::Uint64 offset = readInteger(data + position + 8, 8);
+		sf::Uint64 size = readInteger(data + position + 16, 8);
+		position += IndexEntrySize;
+
+		if (position + nameLength > fileSize || offset > fileSize || size > fileSize - offset)
+			return false;
+
+		Entry entry;
+		entry.data = data + offset;
+		entry.size = static_cast<std::size_t>(size);
+
+		mEntries[std::string(data + position, nameLength)] = entry;
+		position += nameLength;
+	}
+
+	return true;
+}
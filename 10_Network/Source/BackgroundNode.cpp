@@ -0,0 +1,127 @@
+#include <Book/BackgroundNode.hpp>
+
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/Texture.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <climits>
+#include <cmath>
+
+
+namespace
+{
+	const std::size_t ChunkRows = 2;
+	const int NoChunk = INT_MIN;
+
+	int positiveModulo(int value, std::size_t divisor)
+	{
+		int remainder = value % static_cast<int>(divisor);
+		return remainder < 0 ? remainder + static_cast<int>(divisor) : remainder;
+	}
+
+	// Same tile, same variation: the background looks the same every time it is rebuilt
+	std::size_t tileHash(int chunk, std::size_t row, std::size_t column)
+	{
+		unsigned int hash = static_cast<unsigned int>(chunk) * 73856093u ^ static_cast<unsigned int>(row) * 19349663u ^ static_cast<unsigned int>(column) * 83492791u;
+		hash ^= hash >> 13;
+		hash *= 0x5bd1e995u;
+		return hash ^ (hash >> 15);
+	}
+}
+
+BackgroundNode::BackgroundNode(const sf::Texture& texture, float width, std::size_t variations)
+: mTexture(texture)
+, mWidth(width)
+, mVariations(variations)
+, mTileSize(static_cast<float>(texture.getSize().x / variations), static_cast<float>(texture.getSize().y))
+, mColumns(0)
+, mChunkBase(0)
+, mSlotChunks()
+, mVertices()
+{
+	assert(variations > 0 && mTileSize.x > 0.f && mTileSize.y > 0.f);
+	mColumns = static_cast<std::size_t>(std::ceil(mWidth / mTileSize.x));
+}
+
+float BackgroundNode::getChunkHeight() const
+{
+	return ChunkRows * mTileSize.y;
+}
+
+void BackgroundNode::rebase(sf::Vector2f offset)
+{
+	// The node stays in place; moving it would only move the large coordinates into its transform
+	int chunks = static_cast<int>(offset.y / getChunkHeight());
+	assert(chunks * getChunkHeight() == offset.y && offset.x == 0.f);
+
+	// Tiles keep their variation, but all chunks are at new local indices now
+	mChunkBase -= chunks;
+	mSlotChunks.assign(mSlotChunks.size(), NoChunk);
+}
+
+void BackgroundNode::drawCurrent(sf::RenderTarget& target, sf::RenderStates states) const
+{
+	// Part of the view in local coordinates
+	const sf::View& view = target.getView();
+	sf::FloatRect viewBounds(view.getCenter() - view.getSize() / 2.f, view.getSize());
+	updateChunks(states.transform.getInverse().transformRect(viewBounds));
+
+	states.texture = &mTexture;
+	target.draw(&mVertices[0], static_cast<unsigned int>(mVertices.size()), sf::Quads, states);
+}
+
+void BackgroundNode::collectCurrentStatistics(SceneStatistics& statistics) const
+{
+	++statistics.drawCalls;
+}
+
+void BackgroundNode::updateChunks(sf::FloatRect visibleArea) const
+{
+	float chunkHeight = getChunkHeight();
+	int firstChunk = static_cast<int>(std::floor(visibleArea.top / chunkHeight));
+	int lastChunk = static_cast<int>(std::floor((visibleArea.top + visibleArea.height) / chunkHeight));
+	std::size_t chunkCount = static_cast<std::size_t>(lastChunk - firstChunk + 1);
+
+	// A larger view needs more slots; all chunks are rebuilt then
+	if (chunkCount > mSlotChunks.size())
+	{
+		mSlotChunks.assign(chunkCount, NoChunk);
+		mVertices.resize(chunkCount * ChunkRows * mColumns * 4);
+	}
+
+	// Usually nothing changes, or one chunk replaces the one that scrolled out of view
+	for (int chunk = firstChunk; chunk <= lastChunk; ++chunk)
+	{
+		std::size_t slot = positiveModulo(chunk, mSlotChunks.size());
+		if (mSlotChunks[slot] != chunk)
+		{
+			buildChunk(chunk, slot);
+			mSlotChunks[slot] = chunk;
+		}
+	}
+}
+
+void BackgroundNode::buildChunk(int chunk, std::size_t slot) const
+{
+	sf::Vertex* quad = &mVertices[slot * ChunkRows * mColumns * 4];
+	float chunkTop = chunk * getChunkHeight();
+
+	for (std::size_t row = 0; row < ChunkRows; ++row)
+	{
+		for (std::size_t column = 0; column < mColumns; ++column, quad += 4)
+		{
+			// The last column is cut off at the background's width
+			float left = column * mTileSize.x;
+			float top = chunkTop + row * mTileSize.y;
+			float width = std::min(mTileSize.x, mWidth - left);
+
+			float u = (mVariations > 1 ? tileHash(chunk + mChunkBase, row, column) % mVariations : 0) * mTileSize.x;
+
+			quad[0] = sf::Vertex(sf::Vector2f(left, top), sf::Vector2f(u, 0.f));
+			quad[1] = sf::Vertex(sf::Vector2f(left + width, top), sf::Vector2f(u + width, 0.f));
+			quad[2] = sf::Vertex(sf::Vector2f(left + width, top + mTileSize.y), sf::Vector2f(u + width, mTileSize.y));
+			quad[3] = sf::Vertex(sf::Vector2f(left, top + mTileSize.y), sf::Vector2f(u, mTileSize.y));
+		}
+	}
+}
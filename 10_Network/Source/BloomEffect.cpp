@@ -1,56 +1,70 @@
 #include <Book/BloomEffect.hpp>
+#include <Book/RenderTargetPool.hpp>
+#include <Book/Profiler.hpp>
 
 
-BloomEffect::BloomEffect()
-: mShaders()
-, mBrightnessTexture()
-, mFirstPassTextures()
-, mSecondPassTextures()
+BloomEffect::BloomEffect(RenderTargetPool& renderTargets, ShaderHolder& shaders)
+: mShaders(shaders)
+, mRenderTargets(renderTargets)
 {
-	mShaders.load(Shaders::BrightnessPass,   "Media/Shaders/Fullpass.vert", "Media/Shaders/Brightness.frag");
-	mShaders.load(Shaders::DownSamplePass,   "Media/Shaders/Fullpass.vert", "Media/Shaders/DownSample.frag");
-	mShaders.load(Shaders::GaussianBlurPass, "Media/Shaders/Fullpass.vert", "Media/Shaders/GuassianBlur.frag");
-	mShaders.load(Shaders::AddPass,          "Media/Shaders/Fullpass.vert", "Media/Shaders/Add.frag");
+}
+
+void BloomEffect::loadShaders(ResourceLoader& loader, ShaderHolder& shaders)
+{
+	if (shaders.contains(Shaders::BrightnessPass))
+		return;
+
+	shaders.loadAsync(loader, Shaders::BrightnessPass,   "Media/Shaders/Fullpass.vert", "Media/Shaders/Brightness.frag");
+	shaders.loadAsync(loader, Shaders::DownSamplePass,   "Media/Shaders/Fullpass.vert", "Media/Shaders/DownSample.frag");
+	shaders.loadAsync(loader, Shaders::GaussianBlurPass, "Media/Shaders/Fullpass.vert", "Media/Shaders/GuassianBlur.frag");
+	shaders.loadAsync(loader, Shaders::AddPass,          "Media/Shaders/Fullpass.vert", "Media/Shaders/Add.frag");
 }
 
 void BloomEffect::apply(const sf::RenderTexture& input, sf::RenderTarget& output)
 {
-	prepareTextures(input.getSize());
+	BOOK_PROFILE_ZONE("BloomEffect::apply");
 
-	filterBright(input, mBrightnessTexture);
+	// Passes: full size brightness, two blur levels at 1/2 and 1/4 size
+	sf::Vector2u size = input.getSize();
+	RenderTextureArray firstPassTextures;
+	RenderTextureArray secondPassTextures;
 
-	downsample(mBrightnessTexture, mFirstPassTextures[0]);
-	blurMultipass(mFirstPassTextures);
+	sf::RenderTexture& brightnessTexture = mRenderTargets.acquire(size);
+	filterBright(input, brightnessTexture);
 
-	downsample(mFirstPassTextures[0], mSecondPassTextures[0]);
-	blurMultipass(mSecondPassTextures);
+	acquireTextures(firstPassTextures, size / 2u);
+	downsample(brightnessTexture, *firstPassTextures[0]);
+	mRenderTargets.release(brightnessTexture);
+	blurMultipass(firstPassTextures);
 
-	add(mFirstPassTextures[0], mSecondPassTextures[0], mFirstPassTextures[1]);
-	mFirstPassTextures[1].display();
-	add(input, mFirstPassTextures[1], output);
+	acquireTextures(secondPassTextures, size / 4u);
+	downsample(*firstPassTextures[0], *secondPassTextures[0]);
+	blurMultipass(secondPassTextures);
+
+	add(*firstPassTextures[0], *secondPassTextures[0], *firstPassTextures[1]);
+	firstPassTextures[1]->display();
+	add(input, *firstPassTextures[1], output);
+
+	releaseTextures(firstPassTextures);
+	releaseTextures(secondPassTextures);
 }
 
-void BloomEffect::prepareTextures(sf::Vector2u size)
+void BloomEffect::acquireTextures(RenderTextureArray& renderTextures, sf::Vector2u size)
 {
-	if (mBrightnessTexture.getSize() != size)
-	{
-		mBrightnessTexture.create(size.x, size.y);
-		mBrightnessTexture.setSmooth(true);
-
-		mFirstPassTextures[0].create(size.x / 2, size.y / 2);
-		mFirstPassTextures[0].setSmooth(true);
-		mFirstPassTextures[1].create(size.x / 2, size.y / 2);
-		mFirstPassTextures[1].setSmooth(true);
-
-		mSecondPassTextures[0].create(size.x / 4, size.y / 4);
-		mSecondPassTextures[0].setSmooth(true);
-		mSecondPassTextures[1].create(size.x / 4, size.y / 4);
-		mSecondPassTextures[1].setSmooth(true);
-	}
+	renderTextures[0] = &mRenderTargets.acquire(size);
+	renderTextures[1] = &mRenderTargets.acquire(size);
+}
+
+void BloomEffect::releaseTextures(RenderTextureArray& renderTextures)
+{
+	mRenderTargets.release(*renderTextures[0]);
+	mRenderTargets.release(*renderTextures[1]);
 }
 
 void BloomEffect::filterBright(const sf::RenderTexture& input, sf::RenderTexture& output)
 {
+	BOOK_PROFILE_ZONE("BloomEffect::filterBright");
+
 	sf::Shader& brightness = mShaders.get(Shaders::BrightnessPass);
 
 	brightness.setParameter("source", input.getTexture());
@@ -60,12 +74,14 @@ void BloomEffect::filterBright(const sf::RenderTexture& input, sf::RenderTexture
 
 void BloomEffect::blurMultipass(RenderTextureArray& renderTextures)
 {
-	sf::Vector2u textureSize = renderTextures[0].getSize();
+	BOOK_PROFILE_ZONE("BloomEffect::blurMultipass");
+
+	sf::Vector2u textureSize = renderTextures[0]->getSize();
 
 	for (std::size_t count = 0; count < 2; ++count)
 	{
-		blur(renderTextures[0], renderTextures[1], sf::Vector2f(0.f, 1.f / textureSize.y));
-		blur(renderTextures[1], renderTextures[0], sf::Vector2f(1.f / textureSize.x, 0.f));
+		blur(*renderTextures[0], *renderTextures[1], sf::Vector2f(0.f, 1.f / textureSize.y));
+		blur(*renderTextures[1], *renderTextures[0], sf::Vector2f(1.f / textureSize.x, 0.f));
 	}
 }
 
@@ -81,6 +97,8 @@ void BloomEffect::blur(const sf::RenderTexture& input, sf::RenderTexture& output
 
 void BloomEffect::downsample(const sf::RenderTexture& input, sf::RenderTexture& output)
 {
+	BOOK_PROFILE_ZONE("BloomEffect::downsample");
+
 	sf::Shader& downSampler = mShaders.get(Shaders::DownSamplePass);
 
 	downSampler.setParameter("source", input.getTexture());
@@ -91,6 +109,8 @@ void BloomEffect::downsample(const sf::RenderTexture& input, sf::RenderTexture&
 
 void BloomEffect::add(const sf::RenderTexture& source, const sf::RenderTexture& bloom, sf::RenderTarget& output)
 {
+	BOOK_PROFILE_ZONE("BloomEffect::add");
+
 	sf::Shader& adder = mShaders.get(Shaders::AddPass);
 
 	adder.setParameter("source", source.getTexture());
@@ -4,5 +4,6 @@
 Command::Command()
 : action()
 , category(Category::None)
+, target()
 {
 }
@@ -4,6 +4,8 @@
 #include <Book/Pickup.hpp>
 #include <Book/Particle.hpp>
 
+#include <limits>
+
 
 // For std::bind() placeholders _1, _2, ...
 using namespace std::placeholders;
@@ -95,9 +97,48 @@ std::vector<ParticleData> initializeParticleData()
 
 	data[Particle::Propellant].color = sf::Color(255, 255, 50);
 	data[Particle::Propellant].lifetime = sf::seconds(0.6f);
+	data[Particle::Propellant].capacity = 1024;
 
 	data[Particle::Smoke].color = sf::Color(50, 50, 50);
 	data[Particle::Smoke].lifetime = sf::seconds(4.f);
+	data[Particle::Smoke].capacity = 4096;
+
+	return data;
+}
+
+std::vector<SoundEffectData> initializeSoundEffectData()
+{
+	// Higher priorities steal voices from lower ones; sounds further from the listener than cullDistance are not played
+	const float Unlimited = std::numeric_limits<float>::max();
+	std::vector<SoundEffectData> data(SoundEffect::SoundEffectCount);
+
+	data[SoundEffect::AlliedGunfire].priority = 1;
+	data[SoundEffect::AlliedGunfire].maxVoices = 4;
+	data[SoundEffect::AlliedGunfire].cullDistance = 800.f;
+
+	data[SoundEffect::EnemyGunfire].priority = 0;
+	data[SoundEffect::EnemyGunfire].maxVoices = 4;
+	data[SoundEffect::EnemyGunfire].cullDistance = 600.f;
+
+	data[SoundEffect::Explosion1].priority = 2;
+	data[SoundEffect::Explosion1].maxVoices = 4;
+	data[SoundEffect::Explosion1].cullDistance = 1000.f;
+
+	data[SoundEffect::Explosion2].priority = 2;
+	data[SoundEffect::Explosion2].maxVoices = 4;
+	data[SoundEffect::Explosion2].cullDistance = 1000.f;
+
+	data[SoundEffect::LaunchMissile].priority = 2;
+	data[SoundEffect::LaunchMissile].maxVoices = 3;
+	data[SoundEffect::LaunchMissile].cullDistance = 1000.f;
+
+	data[SoundEffect::CollectPickup].priority = 3;
+	data[SoundEffect::CollectPickup].maxVoices = 2;
+	data[SoundEffect::CollectPickup].cullDistance = Unlimited;
+
+	data[SoundEffect::Button].priority = 4;
+	data[SoundEffect::Button].maxVoices = 2;
+	data[SoundEffect::Button].cullDistance = Unlimited;
 
 	return data;
 }
@@ -4,8 +4,25 @@
 #include <Book/Utility.hpp>
 #include <Book/Pickup.hpp>
 #include <Book/Aircraft.hpp>
+#include <Book/LocalChannel.hpp>
+#include <Book/LocalConnection.hpp>
+#include <Book/Profiler.hpp>
+#include <Book/KeyBinding.hpp>
 
 #include <SFML/Network/Packet.hpp>
+#include <SFML/System/Sleep.hpp>
+
+#include <algorithm>
+#include <cassert>
+
+GameServer::Call::Call()
+: type(PlayerEvent)
+, aircraftIdentifier(0)
+, action(0)
+, actionEnabled(false)
+, channel()
+{
+}
 
 GameServer::RemotePeer::RemotePeer() 
 : ready(false)
@@ -14,6 +31,67 @@ GameServer::RemotePeer::RemotePeer()
 	socket.setBlocking(false);
 }
 
+GameServer::RemotePeer::~RemotePeer()
+{
+	reset();
+}
+
+void GameServer::RemotePeer::reset()
+{
+	// Lets a local client notice the disconnection
+	if (channel)
+		channel->close();
+
+	socket.disconnect();
+	channel.reset();
+	overflow.clear();
+	lastPacketTime = sf::Time::Zero;
+	aircraftIdentifiers.clear();
+	ready = false;
+	timedOut = false;
+}
+
+void GameServer::RemotePeer::send(sf::Packet& packet)
+{
+	if (channel)
+	{
+		// Like TCP, the channel must not lose messages: when the client falls behind, they wait here in order
+		flushOverflow();
+		if (!channel->isClosed() && (!overflow.empty() || !channel->sendToClient(packet)))
+			overflow.push_back(packet);
+	}
+	else
+	{
+		socket.send(packet);
+	}
+}
+
+void GameServer::RemotePeer::flushOverflow()
+{
+	while (!overflow.empty() && channel->sendToClient(overflow.front()))
+		overflow.pop_front();
+}
+
+bool GameServer::RemotePeer::receive(sf::Packet& packet, sf::Int32& packetType)
+{
+	if (channel)
+	{
+		LocalChannel::Message message;
+		if (!channel->pollServerMessage(message))
+			return false;
+
+		packet = message.packet;
+		packetType = message.type;
+		return true;
+	}
+
+	if (socket.receive(packet) != sf::Socket::Done)
+		return false;
+
+	packet >> packetType;
+	return true;
+}
+
 GameServer::GameServer(sf::Vector2f battlefieldSize)
 : mThread(&GameServer::executionThread, this)
 , mListeningState(false)
@@ -24,14 +102,25 @@ GameServer::GameServer(sf::Vector2f battlefieldSize)
 , mBattleFieldRect(0.f, mWorldHeight - battlefieldSize.y, battlefieldSize.x, battlefieldSize.y)
 , mBattleFieldScrollSpeed(-50.f)
 , mAircraftCount(0)
-, mPeers(1)
-, mAircraftIdentifierCounter(1)
+, mAircraftInfo()
+, mFreeAircraftSlots()
+, mPeers(mMaxConnectedPlayers)
+, mFreePeerSlots()
 , mWaitingThreadEnd(false)
 , mLastSpawnTime(sf::Time::Zero)
 , mTimeForNextSpawn(sf::seconds(5.f))
+, mMailbox(256)
+, mPendingLocalChannels()
 {
 	mListenerSocket.setBlocking(false);
-	mPeers[0].reset(new RemotePeer());
+
+	// The first connection, the hosting client's, goes into slot 0
+	for (std::size_t i = 0; i < mPeers.size(); ++i)
+	{
+		mPeers[i].reset(new RemotePeer());
+		mFreePeerSlots.push_back(mPeers.size() - 1 - i);
+	}
+
 	mThread.launch();
 }
 
@@ -41,11 +130,86 @@ GameServer::~GameServer()
 	mThread.wait();
 }
 
+std::unique_ptr<ServerConnection> GameServer::connectLocal()
+{
+	auto channel = std::make_shared<LocalChannel>();
+
+	// Attached as a peer by the server thread
+	Call call;
+	call.type = Call::ConnectLocal;
+	call.channel = channel;
+	postCall(call);
+
+	return std::unique_ptr<ServerConnection>(new LocalConnection(channel));
+}
+
+void GameServer::notifyPlayerSpawn(sf::Int32 aircraftIdentifier)
+{
+	Call call;
+	call.type = Call::PlayerSpawn;
+	call.aircraftIdentifier = aircraftIdentifier;
+	postCall(call);
+}
+
 void GameServer::notifyPlayerRealtimeChange(sf::Int32 aircraftIdentifier, sf::Int32 action, bool actionEnabled)
 {
-	for (std::size_t i = 0; i < mConnectedPlayers; ++i)
+	Call call;
+	call.type = Call::PlayerRealtimeChange;
+	call.aircraftIdentifier = aircraftIdentifier;
+	call.action = action;
+	call.actionEnabled = actionEnabled;
+	postCall(call);
+}
+
+void GameServer::notifyPlayerEvent(sf::Int32 aircraftIdentifier, sf::Int32 action)
+{
+	Call call;
+	call.type = Call::PlayerEvent;
+	call.aircraftIdentifier = aircraftIdentifier;
+	call.action = action;
+	postCall(call);
+}
+
+void GameServer::postCall(const Call& call)
+{
+	// The server thread empties the mailbox every loop iteration; only a burst of calls can fill it
+	while (!mMailbox.push(call))
+		sf::sleep(sf::milliseconds(1));
+}
+
+void GameServer::handleCalls()
+{
+	Call call;
+	while (mMailbox.pop(call))
+	{
+		switch (call.type)
+		{
+			case Call::ConnectLocal:
+				mPendingLocalChannels.push_back(call.channel);
+				break;
+
+			case Call::PlayerSpawn:
+				// Ignore aircraft that are gone by now
+				if (findAircraft(call.aircraftIdentifier))
+					sendPlayerSpawn(call.aircraftIdentifier);
+				break;
+
+			case Call::PlayerRealtimeChange:
+				sendPlayerRealtimeChange(call.aircraftIdentifier, call.action, call.actionEnabled);
+				break;
+
+			case Call::PlayerEvent:
+				sendPlayerEvent(call.aircraftIdentifier, call.action);
+				break;
+		}
+	}
+}
+
+void GameServer::sendPlayerRealtimeChange(sf::Int32 aircraftIdentifier, sf::Int32 action, bool actionEnabled)
+{
+	FOREACH(PeerPtr& peer, mPeers)
 	{
-		if (mPeers[i]->ready)
+		if (peer->ready)
 		{
 			sf::Packet packet;
 			packet << static_cast<sf::Int32>(Server::PlayerRealtimeChange);
@@ -53,37 +217,39 @@ void GameServer::notifyPlayerRealtimeChange(sf::Int32 aircraftIdentifier, sf::In
 			packet << action;
 			packet << actionEnabled;
 
-			mPeers[i]->socket.send(packet);
+			peer->send(packet);
 		}
 	}
 }
 
-void GameServer::notifyPlayerEvent(sf::Int32 aircraftIdentifier, sf::Int32 action)
+void GameServer::sendPlayerEvent(sf::Int32 aircraftIdentifier, sf::Int32 action)
 {
-	for (std::size_t i = 0; i < mConnectedPlayers; ++i)
+	FOREACH(PeerPtr& peer, mPeers)
 	{
-		if (mPeers[i]->ready)
+		if (peer->ready)
 		{
 			sf::Packet packet;
 			packet << static_cast<sf::Int32>(Server::PlayerEvent);
 			packet << aircraftIdentifier;
 			packet << action;
 
-			mPeers[i]->socket.send(packet);
+			peer->send(packet);
 		}
 	}
 }
 
-void GameServer::notifyPlayerSpawn(sf::Int32 aircraftIdentifier)
+void GameServer::sendPlayerSpawn(sf::Int32 aircraftIdentifier)
 {
-	for (std::size_t i = 0; i < mConnectedPlayers; ++i)
+	const AircraftInfo& aircraft = *findAircraft(aircraftIdentifier);
+
+	FOREACH(PeerPtr& peer, mPeers)
 	{
-		if (mPeers[i]->ready)
+		if (peer->ready)
 		{
 			sf::Packet packet;
 			packet << static_cast<sf::Int32>(Server::PlayerConnect);
-			packet << aircraftIdentifier << mAircraftInfo[aircraftIdentifier].position.x << mAircraftInfo[aircraftIdentifier].position.y;
-			mPeers[i]->socket.send(packet);
+			packet << aircraftIdentifier << aircraft.position.x << aircraft.position.y;
+			peer->send(packet);
 		}
 	}
 }
@@ -105,6 +271,7 @@ void GameServer::setListening(bool enable)
 
 void GameServer::executionThread()
 {
+	Profiler::setThreadName("Server");
 	setListening(true);
 
 	sf::Time stepInterval = sf::seconds(1.f / 60.f);
@@ -115,9 +282,17 @@ void GameServer::executionThread()
 
 	while (!mWaitingThreadEnd)
 	{	
+		handleCalls();
 		handleIncomingPackets();
 		handleIncomingConnections();
 
+		// Messages held back for a local client go out as soon as it has caught up
+		FOREACH(PeerPtr& peer, mPeers)
+		{
+			if (peer->channel)
+				peer->flushOverflow();
+		}
+
 		stepTime += stepClock.getElapsedTime();
 		stepClock.restart();
 
@@ -145,14 +320,16 @@ void GameServer::executionThread()
 
 void GameServer::tick()
 {
+	BOOK_PROFILE_ZONE("GameServer::tick");
+
 	updateClientState();
 
 	// Check for mission success = all planes with position.y < offset
 	bool allAircraftsDone = true;
-	FOREACH(auto pair, mAircraftInfo)
+	FOREACH(const AircraftInfo& aircraft, mAircraftInfo)
 	{
 		// As long as one player has not crossed the finish line yet, set variable to false
-		if (pair.second.position.y > 0.f)
+		if (isAlive(aircraft) && aircraft.position.y > 0.f)
 			allAircraftsDone = false;
 	}
 	if (allAircraftsDone)
@@ -162,15 +339,6 @@ void GameServer::tick()
 		sendToAll(missionSuccessPacket);
 	}
 
-	// Remove IDs of aircraft that have been destroyed (relevant if a client has two, and loses one)
-	for (auto itr = mAircraftInfo.begin(); itr != mAircraftInfo.end(); )
-	{
-		if (itr->second.hitpoints <= 0)
-			mAircraftInfo.erase(itr++);
-		else
-			++itr;
-	}
-
 	// Check if its time to attempt to spawn enemies
 	if (now() >= mTimeForNextSpawn + mLastSpawnTime)
 	{	
@@ -218,6 +386,8 @@ sf::Time GameServer::now() const
 
 void GameServer::handleIncomingPackets()
 {
+	BOOK_PROFILE_ZONE("GameServer::handleIncomingPackets");
+
 	bool detectedTimeout = false;
 	
 	FOREACH(PeerPtr& peer, mPeers)
@@ -225,17 +395,18 @@ void GameServer::handleIncomingPackets()
 		if (peer->ready)
 		{
 			sf::Packet packet;
-			while (peer->socket.receive(packet) == sf::Socket::Done)
+			sf::Int32 packetType;
+			while (peer->receive(packet, packetType))
 			{
 				// Interpret packet and react to it
-				handleIncomingPacket(packet, *peer, detectedTimeout);
+				handleIncomingPacket(packetType, packet, *peer, detectedTimeout);
 
 				// Packet was indeed received, update the ping timer
 				peer->lastPacketTime = now();
 				packet.clear();
 			}
 
-			if (now() >= peer->lastPacketTime + mClientTimeoutTime)
+			if (now() >= peer->lastPacketTime + mClientTimeoutTime || (peer->channel && peer->channel->isClosed()))
 			{
 				peer->timedOut = true;
 				detectedTimeout = true;
@@ -247,11 +418,8 @@ void GameServer::handleIncomingPackets()
 		handleDisconnections();
 }
 
-void GameServer::handleIncomingPacket(sf::Packet& packet, RemotePeer& receivingPeer, bool& detectedTimeout)
+void GameServer::handleIncomingPacket(sf::Int32 packetType, sf::Packet& packet, RemotePeer& receivingPeer, bool& detectedTimeout)
 {
-	sf::Int32 packetType;
-	packet >> packetType;
-
 	switch (packetType)
 	{
 		case Client::Quit:
@@ -266,7 +434,7 @@ void GameServer::handleIncomingPacket(sf::Packet& packet, RemotePeer& receivingP
 			sf::Int32 action;
 			packet >> aircraftIdentifier >> action;
 
-			notifyPlayerEvent(aircraftIdentifier, action);
+			sendPlayerEvent(aircraftIdentifier, action);
 		} break;
 
 		case Client::PlayerRealtimeChange:
@@ -275,24 +443,32 @@ void GameServer::handleIncomingPacket(sf::Packet& packet, RemotePeer& receivingP
 			sf::Int32 action;
 			bool actionEnabled;
 			packet >> aircraftIdentifier >> action >> actionEnabled;
-			mAircraftInfo[aircraftIdentifier].realtimeActions[action] = actionEnabled;
-			notifyPlayerRealtimeChange(aircraftIdentifier, action, actionEnabled);
+
+			AircraftInfo* aircraft = findAircraft(aircraftIdentifier);
+			if (aircraft && action >= 0 && action < PlayerAction::Count)
+			{
+				if (actionEnabled)
+					aircraft->realtimeActions |= 1u << action;
+				else
+					aircraft->realtimeActions &= ~(1u << action);
+			}
+
+			sendPlayerRealtimeChange(aircraftIdentifier, action, actionEnabled);
 		} break;
 
 		case Client::RequestCoopPartner:
 		{
-			receivingPeer.aircraftIdentifiers.push_back(mAircraftIdentifierCounter);
-			mAircraftInfo[mAircraftIdentifierCounter].position = sf::Vector2f(mBattleFieldRect.width / 2, mBattleFieldRect.top + mBattleFieldRect.height / 2);
-			mAircraftInfo[mAircraftIdentifierCounter].hitpoints = 100;
-			mAircraftInfo[mAircraftIdentifierCounter].missileAmmo = 2;
+			sf::Int32 aircraftIdentifier = createAircraft();
+			const AircraftInfo& aircraft = *findAircraft(aircraftIdentifier);
+			receivingPeer.aircraftIdentifiers.push_back(aircraftIdentifier);
 
 			sf::Packet requestPacket;
 			requestPacket << static_cast<sf::Int32>(Server::AcceptCoopPartner);
-			requestPacket << mAircraftIdentifierCounter;
-			requestPacket << mAircraftInfo[mAircraftIdentifierCounter].position.x;
-			requestPacket << mAircraftInfo[mAircraftIdentifierCounter].position.y;
+			requestPacket << aircraftIdentifier;
+			requestPacket << aircraft.position.x;
+			requestPacket << aircraft.position.y;
 
-			receivingPeer.socket.send(requestPacket);
+			receivingPeer.send(requestPacket);
 			mAircraftCount++;
 
 			// Inform every other peer about this new plane
@@ -302,13 +478,12 @@ void GameServer::handleIncomingPacket(sf::Packet& packet, RemotePeer& receivingP
 				{
 					sf::Packet notifyPacket;
 					notifyPacket << static_cast<sf::Int32>(Server::PlayerConnect);
-					notifyPacket << mAircraftIdentifierCounter;
-					notifyPacket << mAircraftInfo[mAircraftIdentifierCounter].position.x;
-					notifyPacket << mAircraftInfo[mAircraftIdentifierCounter].position.y;
-					peer->socket.send(notifyPacket);
+					notifyPacket << aircraftIdentifier;
+					notifyPacket << aircraft.position.x;
+					notifyPacket << aircraft.position.y;
+					peer->send(notifyPacket);
 				}
 			}
-			mAircraftIdentifierCounter++;
 		} break;
 
 		case Client::PositionUpdate:
@@ -323,9 +498,13 @@ void GameServer::handleIncomingPacket(sf::Packet& packet, RemotePeer& receivingP
 				sf::Int32 missileAmmo;
 				sf::Vector2f aircraftPosition;
 				packet >> aircraftIdentifier >> aircraftPosition.x >> aircraftPosition.y >> aircraftHitpoints >> missileAmmo;
-				mAircraftInfo[aircraftIdentifier].position = aircraftPosition;
-				mAircraftInfo[aircraftIdentifier].hitpoints = aircraftHitpoints;
-				mAircraftInfo[aircraftIdentifier].missileAmmo = missileAmmo;
+
+				if (AircraftInfo* aircraft = findAircraft(aircraftIdentifier))
+				{
+					aircraft->position = aircraftPosition;
+					aircraft->hitpoints = aircraftHitpoints;
+					aircraft->missileAmmo = missileAmmo;
+				}
 			}
 		} break;
 
@@ -360,117 +539,133 @@ void GameServer::updateClientState()
 	sf::Packet updateClientStatePacket;
 	updateClientStatePacket << static_cast<sf::Int32>(Server::UpdateClientState);
 	updateClientStatePacket << static_cast<float>(mBattleFieldRect.top + mBattleFieldRect.height);
-	updateClientStatePacket << static_cast<sf::Int32>(mAircraftInfo.size());
+	updateClientStatePacket << static_cast<sf::Int32>(std::count_if(mAircraftInfo.begin(), mAircraftInfo.end(), [this] (const AircraftInfo& aircraft)
+	{
+		return isAlive(aircraft);
+	}));
 
-	FOREACH(auto aircraft, mAircraftInfo)
-		updateClientStatePacket << aircraft.first << aircraft.second.position.x << aircraft.second.position.y;
+	for (std::size_t i = 0; i < mAircraftInfo.size(); ++i)
+	{
+		if (isAlive(mAircraftInfo[i]))
+			updateClientStatePacket << static_cast<sf::Int32>(i + 1) << mAircraftInfo[i].position.x << mAircraftInfo[i].position.y;
+	}
 
 	sendToAll(updateClientStatePacket);
 }
 
 void GameServer::handleIncomingConnections()
 {
-	if (!mListeningState)
-		return;
-
-	if (mListenerSocket.accept(mPeers[mConnectedPlayers]->socket) == sf::TcpListener::Done)
+	// Local clients are attached to the waiting peer like an accepted socket
+	while (!mPendingLocalChannels.empty() && !mFreePeerSlots.empty())
 	{
-		// order the new client to spawn its own plane ( player 1 )
-		mAircraftInfo[mAircraftIdentifierCounter].position = sf::Vector2f(mBattleFieldRect.width / 2, mBattleFieldRect.top + mBattleFieldRect.height / 2);
-		mAircraftInfo[mAircraftIdentifierCounter].hitpoints = 100;
-		mAircraftInfo[mAircraftIdentifierCounter].missileAmmo = 2;
-
-		sf::Packet packet;
-		packet << static_cast<sf::Int32>(Server::SpawnSelf);
-		packet << mAircraftIdentifierCounter;
-		packet << mAircraftInfo[mAircraftIdentifierCounter].position.x;
-		packet << mAircraftInfo[mAircraftIdentifierCounter].position.y;
-		
-		mPeers[mConnectedPlayers]->aircraftIdentifiers.push_back(mAircraftIdentifierCounter);
-		
-		broadcastMessage("New player!");
-		informWorldState(mPeers[mConnectedPlayers]->socket);
-		notifyPlayerSpawn(mAircraftIdentifierCounter++);
-
-		mPeers[mConnectedPlayers]->socket.send(packet);
-		mPeers[mConnectedPlayers]->ready = true;
-		mPeers[mConnectedPlayers]->lastPacketTime = now(); // prevent initial timeouts
-		mAircraftCount++;
-		mConnectedPlayers++;
-
-		if (mConnectedPlayers >= mMaxConnectedPlayers)
-			setListening(false);
-		else // Add a new waiting peer
-			mPeers.push_back(PeerPtr(new RemotePeer()));
+		RemotePeer& peer = *mPeers[mFreePeerSlots.back()];
+		peer.channel = mPendingLocalChannels.front();
+		mPendingLocalChannels.erase(mPendingLocalChannels.begin());
+		acceptPeer(peer);
 	}
+
+	if (!mListeningState || mFreePeerSlots.empty())
+		return;
+
+	RemotePeer& peer = *mPeers[mFreePeerSlots.back()];
+	if (mListenerSocket.accept(peer.socket) == sf::TcpListener::Done)
+		acceptPeer(peer);
+}
+
+void GameServer::acceptPeer(RemotePeer& peer)
+{
+	// The peer is always accepted into the last free slot
+	assert(!mFreePeerSlots.empty() && &peer == mPeers[mFreePeerSlots.back()].get());
+	mFreePeerSlots.pop_back();
+
+	// order the new client to spawn its own plane ( player 1 )
+	sf::Int32 aircraftIdentifier = createAircraft();
+	const AircraftInfo& aircraft = *findAircraft(aircraftIdentifier);
+
+	sf::Packet packet;
+	packet << static_cast<sf::Int32>(Server::SpawnSelf);
+	packet << aircraftIdentifier;
+	packet << aircraft.position.x;
+	packet << aircraft.position.y;
+	
+	peer.aircraftIdentifiers.push_back(aircraftIdentifier);
+	
+	broadcastMessage("New player!");
+	informWorldState(peer);
+	sendPlayerSpawn(aircraftIdentifier);
+
+	peer.send(packet);
+	peer.ready = true;
+	peer.lastPacketTime = now(); // prevent initial timeouts
+	mAircraftCount++;
+	mConnectedPlayers++;
+
+	if (mFreePeerSlots.empty())
+		setListening(false);
 }
 
 void GameServer::handleDisconnections()
 {
-	for (auto itr = mPeers.begin(); itr != mPeers.end(); )
+	for (std::size_t i = 0; i < mPeers.size(); ++i)
 	{
-		if ((*itr)->timedOut)
+		RemotePeer& peer = *mPeers[i];
+		if (peer.timedOut)
 		{
-			// Inform everyone of the disconnection, erase 
-			FOREACH(sf::Int32 identifier, (*itr)->aircraftIdentifiers)
+			// Inform everyone of the disconnection, free the peer's aircraft
+			FOREACH(sf::Int32 identifier, peer.aircraftIdentifiers)
 			{
 				sendToAll(sf::Packet() << static_cast<sf::Int32>(Server::PlayerDisconnect) << identifier);
 
-				mAircraftInfo.erase(identifier);
+				destroyAircraft(identifier);
 			}
 
 			mConnectedPlayers--;
-			mAircraftCount -= (*itr)->aircraftIdentifiers.size();
+			mAircraftCount -= peer.aircraftIdentifiers.size();
 
-			itr = mPeers.erase(itr);
-
-			// Go back to a listening state if needed
-			if (mConnectedPlayers < mMaxConnectedPlayers)
-			{
-				mPeers.push_back(PeerPtr(new RemotePeer()));
-				setListening(true);
-			}
+			// The slot waits for the next connection, go back to a listening state
+			peer.reset();
+			mFreePeerSlots.push_back(i);
+			setListening(true);
 				
 			broadcastMessage("An ally has disconnected.");
 		}
-		else
-		{
-			++itr;
-		}
 	}
 }
 
 // Tell the newly connected peer about how the world is currently
-void GameServer::informWorldState(sf::TcpSocket& socket)
+void GameServer::informWorldState(RemotePeer& peer)
 {
 	sf::Packet packet;
 	packet << static_cast<sf::Int32>(Server::InitialState);
 	packet << mWorldHeight << mBattleFieldRect.top + mBattleFieldRect.height;
 	packet << static_cast<sf::Int32>(mAircraftCount);
 
-	for (std::size_t i = 0; i < mConnectedPlayers; ++i)
+	FOREACH(PeerPtr& peer, mPeers)
 	{
-		if (mPeers[i]->ready)
+		if (peer->ready)
 		{
-			FOREACH(sf::Int32 identifier, mPeers[i]->aircraftIdentifiers)
-				packet << identifier << mAircraftInfo[identifier].position.x << mAircraftInfo[identifier].position.y << mAircraftInfo[identifier].hitpoints << mAircraftInfo[identifier].missileAmmo;
+			FOREACH(sf::Int32 identifier, peer->aircraftIdentifiers)
+			{
+				const AircraftInfo& aircraft = *findAircraft(identifier);
+				packet << identifier << aircraft.position.x << aircraft.position.y << aircraft.hitpoints << aircraft.missileAmmo;
+			}
 		}
 	}
 
-	socket.send(packet);
+	peer.send(packet);
 }
 
 void GameServer::broadcastMessage(const std::string& message)
 {
-	for (std::size_t i = 0; i < mConnectedPlayers; ++i)
+	FOREACH(PeerPtr& peer, mPeers)
 	{
-		if (mPeers[i]->ready)
+		if (peer->ready)
 		{
 			sf::Packet packet;
 			packet << static_cast<sf::Int32>(Server::BroadcastMessage);
 			packet << message;
 
-			mPeers[i]->socket.send(packet);
+			peer->send(packet);
 		}	
 	}
 }
@@ -480,6 +675,52 @@ void GameServer::sendToAll(sf::Packet& packet)
 	FOREACH(PeerPtr& peer, mPeers)
 	{
 		if (peer->ready)
-			peer->socket.send(packet);
+			peer->send(packet);
 	}
 }
+
+sf::Int32 GameServer::createAircraft()
+{
+	if (mFreeAircraftSlots.empty())
+	{
+		mFreeAircraftSlots.push_back(mAircraftInfo.size());
+		mAircraftInfo.push_back(AircraftInfo());
+	}
+
+	std::size_t slot = mFreeAircraftSlots.back();
+	mFreeAircraftSlots.pop_back();
+
+	AircraftInfo& aircraft = mAircraftInfo[slot];
+	aircraft.position = sf::Vector2f(mBattleFieldRect.width / 2, mBattleFieldRect.top + mBattleFieldRect.height / 2);
+	aircraft.hitpoints = 100;
+	aircraft.missileAmmo = 2;
+	aircraft.realtimeActions = 0;
+	aircraft.inUse = true;
+
+	// Identifier 0 is never used
+	return static_cast<sf::Int32>(slot + 1);
+}
+
+void GameServer::destroyAircraft(sf::Int32 identifier)
+{
+	AircraftInfo* aircraft = findAircraft(identifier);
+	assert(aircraft);
+
+	aircraft->inUse = false;
+	mFreeAircraftSlots.push_back(identifier - 1);
+}
+
+GameServer::AircraftInfo* GameServer::findAircraft(sf::Int32 identifier)
+{
+	// Identifiers come from clients too, unknown ones are ignored
+	if (identifier < 1 || static_cast<std::size_t>(identifier) > mAircraftInfo.size() || !mAircraftInfo[identifier - 1].inUse)
+		return nullptr;
+
+	return &mAircraftInfo[identifier - 1];
+}
+
+bool GameServer::isAlive(const AircraftInfo& aircraft) const
+{
+	// Slots of destroyed aircraft stay with their peer until it disconnects
+	return aircraft.inUse && aircraft.hitpoints > 0;
+}
@@ -3,13 +3,22 @@
 
 #include <SFML/Graphics/RenderWindow.hpp>
 
+#include <ctime>
 
-GameState::GameState(StateStack& stack, Context context)
+
+GameState::GameState(StateStack& stack, Context context, bool endless)
 : State(stack, context)
-, mWorld(*context.window, *context.fonts, *context.sounds, false)
+, mWorld(*context.window, *context.textures, *context.shaders, *context.fonts, *context.sounds, *context.statistics, false)
 , mPlayer(nullptr, 1, context.keys1)
 {
+	mWorld.setMinResolutionScale(context.minResolutionScale);
+
+	// A new sequence of waves every game
+	if (endless)
+		mWorld.setEndlessMode(static_cast<unsigned int>(std::time(nullptr)));
+
 	mWorld.addAircraft(1);
+	mPlayer.setAircraft(mWorld.getAircraftHandle(1));
 	mPlayer.setMissionStatus(Player::MissionRunning);
 
 	// Play game theme
@@ -42,6 +51,11 @@ bool GameState::update(sf::Time dt)
 	return true;
 }
 
+void GameState::setInterpolation(float alpha)
+{
+	mWorld.setInterpolation(alpha);
+}
+
 bool GameState::handleEvent(const sf::Event& event)
 {
 	// Game input handling
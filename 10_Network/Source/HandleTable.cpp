@@ -0,0 +1,13 @@
+#include <Book/HandleTable.hpp>
+
+
+Handle::Handle()
+: index(0)
+, generation(0)
+{
+}
+
+bool Handle::isValid() const
+{
+	return generation != 0;
+}
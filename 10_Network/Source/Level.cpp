@@ -0,0 +1,127 @@
+#include <Book/Level.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+
+namespace
+{
+	// Little-endian layout: header { magic, version, spawn count, reserved },
+	// then per spawn { float distance, float x, uint32 type, uint32 reserved }
+	const char Magic[4] = { 'B', 'L', 'V', 'L' };
+	const sf::Uint32 Version = 1;
+	const std::size_t HeaderSize = 16;
+	const std::size_t SpawnSize = 16;
+
+	sf::Uint32 readInteger(const char* data)
+	{
+		sf::Uint32 value = 0;
+		for (std::size_t i = 0; i < 4; ++i)
+			value |= static_cast<sf::Uint32>(static_cast<unsigned char>(data[i])) << (8 * i);
+
+		return value;
+	}
+
+	float readFloat(const char* data)
+	{
+		sf::Uint32 bits = readInteger(data);
+		float value;
+		std::memcpy(&value, &bits, sizeof(value));
+		return value;
+	}
+
+	void writeInteger(std::ostream& stream, sf::Uint32 value)
+	{
+		for (std::size_t i = 0; i < 4; ++i)
+			stream.put(static_cast<char>((value >> (8 * i)) & 0xff));
+	}
+
+	void writeFloat(std::ostream& stream, float value)
+	{
+		sf::Uint32 bits;
+		std::memcpy(&bits, &value, sizeof(bits));
+		writeInteger(stream, bits);
+	}
+}
+
+Level::Spawn::Spawn()
+: type(Aircraft::Raptor)
+, x(0.f)
+, distance(0.f)
+{
+}
+
+Level::Spawn::Spawn(Aircraft::Type type, float x, float distance)
+: type(type)
+, x(x)
+, distance(distance)
+{
+}
+
+Level::Level()
+: mFile()
+, mSpawnCount(0)
+{
+}
+
+void Level::loadFromFile(const std::string& filename)
+{
+	mSpawnCount = 0;
+	if (!mFile.open(filename))
+		throw std::runtime_error("Level::loadFromFile - Failed to load " + filename);
+
+	const char* data = mFile.getData();
+	if (mFile.getSize() < HeaderSize || std::memcmp(data, Magic, sizeof(Magic)) != 0 || readInteger(data + 4) != Version)
+		throw std::runtime_error("Level::loadFromFile - " + filename + " is not a level file");
+
+	std::size_t spawnCount = readInteger(data + 8);
+	if (mFile.getSize() < HeaderSize + spawnCount * SpawnSize)
+		throw std::runtime_error("Level::loadFromFile - " + filename + " is truncated");
+
+	mSpawnCount = spawnCount;
+}
+
+std::size_t Level::getSpawnCount() const
+{
+	return mSpawnCount;
+}
+
+Level::Spawn Level::getSpawn(std::size_t index) const
+{
+	assert(index < mSpawnCount);
+
+	const char* data = mFile.getData() + HeaderSize + index * SpawnSize;
+	sf::Uint32 type = readInteger(data + 8);
+	if (type >= Aircraft::TypeCount)
+		throw std::runtime_error("Level::getSpawn - Invalid aircraft type");
+
+	return Spawn(static_cast<Aircraft::Type>(type), readFloat(data + 4), readFloat(data));
+}
+
+bool Level::save(const std::string& filename, std::vector<Spawn> spawns)
+{
+	// Stable, so spawns at the same distance keep their order
+	std::stable_sort(spawns.begin(), spawns.end(), [] (const Spawn& lhs, const Spawn& rhs)
+	{
+		return lhs.distance < rhs.distance;
+	});
+
+	std::ofstream output(filename.c_str(), std::ios::binary);
+	output.write(Magic, sizeof(Magic));
+	writeInteger(output, Version);
+	writeInteger(output, static_cast<sf::Uint32>(spawns.size()));
+	writeInteger(output, 0);
+
+	for (std::size_t i = 0; i < spawns.size(); ++i)
+	{
+		writeFloat(output, spawns[i].distance);
+		writeFloat(output, spawns[i].x);
+		writeInteger(output, static_cast<sf::Uint32>(spawns[i].type));
+		writeInteger(output, 0);
+	}
+
+	return static_cast<bool>(output);
+}
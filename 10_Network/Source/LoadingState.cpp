@@ -0,0 +1,88 @@
+#include <Book/LoadingState.hpp>
+#include <Book/World.hpp>
+#include <Book/ResourceHolder.hpp>
+#include <Book/ResourceLoader.hpp>
+#include <Book/MusicPlayer.hpp>
+#include <Book/Utility.hpp>
+
+#include <SFML/Graphics/RenderWindow.hpp>
+#include <SFML/Graphics/View.hpp>
+
+
+LoadingState::LoadingState(StateStack& stack, Context context, States::ID nextState)
+: State(stack, context)
+, mLoadingText()
+, mProgressBarBackground()
+, mProgressBar()
+, mNextState(nextState)
+{
+	sf::Font& font = context.fonts->get(Fonts::Main);
+	sf::Vector2f viewSize = context.window->getView().getSize();
+
+	mLoadingText.setFont(font);
+	mLoadingText.setString("Loading Resources");
+	centerOrigin(mLoadingText);
+	mLoadingText.setPosition(viewSize.x / 2.f, viewSize.y / 2.f + 50.f);
+
+	mProgressBarBackground.setFillColor(sf::Color::White);
+	mProgressBarBackground.setSize(sf::Vector2f(viewSize.x - 20.f, 10.f));
+	mProgressBarBackground.setPosition(10.f, mLoadingText.getPosition().y + 40.f);
+
+	mProgressBar.setFillColor(sf::Color(100, 100, 100));
+	mProgressBar.setSize(sf::Vector2f(200.f, 10.f));
+	mProgressBar.setPosition(10.f, mLoadingText.getPosition().y + 40.f);
+
+	setCompletion(0.f);
+
+	// Resources already loaded by a previous game are skipped
+	World::loadResources(*context.loader, *context.textures, *context.shaders);
+	context.music->prefetch(Music::MissionTheme);
+}
+
+void LoadingState::draw()
+{
+	sf::RenderWindow& window = *getContext().window;
+
+	window.setView(window.getDefaultView());
+
+	window.draw(mLoadingText);
+	window.draw(mProgressBarBackground);
+	window.draw(mProgressBar);
+}
+
+bool LoadingState::update(sf::Time)
+{
+	// The application finalizes loaded resources between frames
+	ResourceLoader& loader = *getContext().loader;
+	if (loader.isFinished())
+	{
+		requestStackPop();
+		requestStackPush(mNextState);
+	}
+	else
+	{
+		setCompletion(loader.getCompletion());
+	}
+
+	return true;
+}
+
+bool LoadingState::handleEvent(const sf::Event& event)
+{
+	// Cancel; jobs already queued keep loading in the background and are reused by the next attempt
+	if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::Escape)
+	{
+		requestStackPop();
+		requestStackPush(States::Menu);
+	}
+
+	return true;
+}
+
+void LoadingState::setCompletion(float percent)
+{
+	if (percent > 1.f)
+		percent = 1.f;
+
+	mProgressBar.setSize(sf::Vector2f(mProgressBarBackground.getSize().x * percent, mProgressBar.getSize().y));
+}
@@ -0,0 +1,69 @@
+#include <Book/LocalChannel.hpp>
+
+
+namespace
+{
+	const std::size_t QueueCapacity = 1024;
+}
+
+LocalChannel::LocalChannel()
+: mClock()
+, mToClient(QueueCapacity)
+, mToServer(QueueCapacity)
+, mClosed(false)
+{
+}
+
+bool LocalChannel::sendToServer(const sf::Packet& packet)
+{
+	return push(mToServer, packet);
+}
+
+bool LocalChannel::pollClientMessage(Message& message)
+{
+	return mToClient.pop(message);
+}
+
+std::size_t LocalChannel::getPendingClientMessageCount() const
+{
+	return mToClient.size();
+}
+
+bool LocalChannel::sendToClient(const sf::Packet& packet)
+{
+	return push(mToClient, packet);
+}
+
+bool LocalChannel::pollServerMessage(Message& message)
+{
+	return mToServer.pop(message);
+}
+
+void LocalChannel::close()
+{
+	mClosed = true;
+}
+
+bool LocalChannel::isClosed() const
+{
+	return mClosed;
+}
+
+sf::Time LocalChannel::now() const
+{
+	return mClock.getElapsedTime();
+}
+
+bool LocalChannel::push(SpscQueue<Message>& queue, const sf::Packet& packet)
+{
+	if (mClosed)
+		return false;
+
+	// Same decoded form a RemoteConnection delivers: type read off, stamped on arrival
+	Message message;
+	message.packet = packet;
+	message.packet >> message.type;
+	message.arrivalTime = now();
+
+	return queue.push(message);
+}
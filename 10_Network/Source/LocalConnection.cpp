@@ -0,0 +1,74 @@
+#include <Book/LocalConnection.hpp>
+#include <Book/LocalChannel.hpp>
+
+
+LocalConnection::LocalConnection(std::shared_ptr<LocalChannel> channel)
+: mChannel(std::move(channel))
+, mBytesReceived(0)
+, mBytesSent(0)
+{
+}
+
+LocalConnection::~LocalConnection()
+{
+	// The server drops the peer on its next update
+	mChannel->close();
+}
+
+ServerConnection::Status LocalConnection::getStatus() const
+{
+	return mChannel->isClosed() ? Disconnected : Connected;
+}
+
+sf::Time LocalConnection::now() const
+{
+	return mChannel->now();
+}
+
+sf::Time LocalConnection::getResolveTime() const
+{
+	return sf::Time::Zero;
+}
+
+sf::Time LocalConnection::getConnectTime() const
+{
+	return sf::Time::Zero;
+}
+
+std::size_t LocalConnection::getConnectAttempts() const
+{
+	return 1;
+}
+
+bool LocalConnection::send(const sf::Packet& packet)
+{
+	if (!mChannel->sendToServer(packet))
+		return false;
+
+	mBytesSent += packet.getDataSize();
+	return true;
+}
+
+bool LocalConnection::pollMessage(Message& message)
+{
+	if (!mChannel->pollClientMessage(message))
+		return false;
+
+	mBytesReceived += message.packet.getDataSize();
+	return true;
+}
+
+std::size_t LocalConnection::getPendingMessageCount() const
+{
+	return mChannel->getPendingClientMessageCount();
+}
+
+std::size_t LocalConnection::getBytesReceived() const
+{
+	return mBytesReceived;
+}
+
+std::size_t LocalConnection::getBytesSent() const
+{
+	return mBytesSent;
+}
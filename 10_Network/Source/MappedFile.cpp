@@ -0,0 +1,101 @@
+#include <Book/MappedFile.hpp>
+
+#ifdef _WIN32
+	#define WIN32_LEAN_AND_MEAN
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+
+MappedFile::MappedFile()
+: mData(nullptr)
+, mSize(0)
+{
+}
+
+MappedFile::~MappedFile()
+{
+	close();
+}
+
+bool MappedFile::open(const std::string& filename)
+{
+	close();
+
+#ifdef _WIN32
+	HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER size;
+	HANDLE mapping = nullptr;
+	if (GetFileSizeEx(file, &size) && size.QuadPart > 0)
+		mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+	// The view keeps the mapping alive, both handles can be closed
+	CloseHandle(file);
+	if (!mapping)
+		return false;
+
+	const void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	CloseHandle(mapping);
+	if (!data)
+		return false;
+
+	mData = static_cast<const char*>(data);
+	mSize = static_cast<std::size_t>(size.QuadPart);
+#else
+	int file = ::open(filename.c_str(), O_RDONLY);
+	if (file < 0)
+		return false;
+
+	struct stat status;
+	void* data = MAP_FAILED;
+	if (fstat(file, &status) == 0 && status.st_size > 0)
+		data = mmap(nullptr, status.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+
+	// The mapping stays valid after closing the descriptor
+	::close(file);
+	if (data == MAP_FAILED)
+		return false;
+
+	mData = static_cast<const char*>(data);
+	mSize = static_cast<std::size_t>(status.st_size);
+#endif
+
+	return true;
+}
+
+void MappedFile::close()
+{
+	if (!mData)
+		return;
+
+#ifdef _WIN32
+	UnmapViewOfFile(mData);
+#else
+	munmap(const_cast<char*>(mData), mSize);
+#endif
+
+	mData = nullptr;
+	mSize = 0;
+}
+
+bool MappedFile::isOpen() const
+{
+	return mData != nullptr;
+}
+
+const char* MappedFile::getData() const
+{
+	return mData;
+}
+
+std::size_t MappedFile::getSize() const
+{
+	return mSize;
+}
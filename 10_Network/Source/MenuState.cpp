@@ -21,29 +21,38 @@ MenuState::MenuState(StateStack& stack, Context context)
 	playButton->setCallback([this] ()
 	{
 		requestStackPop();
-		requestStackPush(States::Game);
+		requestStackPush(States::Loading);
+	});
+
+	auto endlessButton = std::make_shared<GUI::Button>(context);
+	endlessButton->setPosition(100, 350);
+	endlessButton->setText("Endless");
+	endlessButton->setCallback([this] ()
+	{
+		requestStackPop();
+		requestStackPush(States::LoadingEndlessGame);
 	});
 
 	auto hostPlayButton = std::make_shared<GUI::Button>(context);
-	hostPlayButton->setPosition(100, 350);
+	hostPlayButton->setPosition(100, 400);
 	hostPlayButton->setText("Host");
 	hostPlayButton->setCallback([this] ()
 	{
 		requestStackPop();
-		requestStackPush(States::HostGame);
+		requestStackPush(States::LoadingHostGame);
 	});
 
 	auto joinPlayButton = std::make_shared<GUI::Button>(context);
-	joinPlayButton->setPosition(100, 400);
+	joinPlayButton->setPosition(100, 450);
 	joinPlayButton->setText("Join");
 	joinPlayButton->setCallback([this] ()
 	{
 		requestStackPop();
-		requestStackPush(States::JoinGame);
+		requestStackPush(States::LoadingJoinGame);
 	});
 
 	auto settingsButton = std::make_shared<GUI::Button>(context);
-	settingsButton->setPosition(100, 450);
+	settingsButton->setPosition(100, 500);
 	settingsButton->setText("Settings");
 	settingsButton->setCallback([this] ()
 	{
@@ -51,7 +60,7 @@ MenuState::MenuState(StateStack& stack, Context context)
 	});
 
 	auto exitButton = std::make_shared<GUI::Button>(context);
-	exitButton->setPosition(100, 500);
+	exitButton->setPosition(100, 550);
 	exitButton->setText("Exit");
 	exitButton->setCallback([this] ()
 	{
@@ -59,6 +68,7 @@ MenuState::MenuState(StateStack& stack, Context context)
 	});
 
 	mGUIContainer.pack(playButton);
+	mGUIContainer.pack(endlessButton);
 	mGUIContainer.pack(hostPlayButton);
 	mGUIContainer.pack(joinPlayButton);
 	mGUIContainer.pack(settingsButton);
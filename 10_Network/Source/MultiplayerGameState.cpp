@@ -1,15 +1,23 @@
 #include <Book/MultiplayerGameState.hpp>
 #include <Book/MusicPlayer.hpp>
+#include <Book/Statistics.hpp>
+#include <Book/RemoteConnection.hpp>
 #include <Book/Foreach.hpp>
 #include <Book/Utility.hpp>
 
 #include <SFML/Graphics/RenderWindow.hpp>
-#include <SFML/Network/IpAddress.hpp>
 
 #include <fstream>
+#include <algorithm>
 
 
-sf::IpAddress getAddressFromFile()
+namespace
+{
+	const sf::Time ConnectTimeout = sf::seconds(5.f);
+	const sf::Time HandshakeTimeout = sf::seconds(5.f);
+}
+
+std::string getAddressFromFile()
 {
 	{ // Try to open existing file (RAII block)
 		std::ifstream inputFile("ip.txt");
@@ -27,10 +35,9 @@ sf::IpAddress getAddressFromFile()
 
 MultiplayerGameState::MultiplayerGameState(StateStack& stack, Context context, bool isHost)
 : State(stack, context)
-, mWorld(*context.window, *context.fonts, *context.sounds, true)
+, mWorld(*context.window, *context.textures, *context.shaders, *context.fonts, *context.sounds, *context.statistics, true)
 , mWindow(*context.window)
 , mTextureHolder(*context.textures)
-, mConnected(false)
 , mGameServer(nullptr)
 , mActiveState(true)
 , mHasFocus(true)
@@ -38,7 +45,21 @@ MultiplayerGameState::MultiplayerGameState(StateStack& stack, Context context, b
 , mGameStarted(false)
 , mClientTimeout(sf::seconds(2.f))
 , mTimeSinceLastPacket(sf::seconds(0.f))
+, mConnection(nullptr)
+, mConnectionPhase(Resolving)
+, mConnectionClock()
+, mConnectTime()
+, mReceivedInitialState(false)
+, mPacketBudget(64)
+, mPacketTimeBudget(sf::milliseconds(2))
+, mPeakPacketQueueDepth(0)
+, mPeakPacketDelay()
+, mTrafficClock()
+, mLastBytesReceived(0)
+, mLastBytesSent(0)
 {
+	mWorld.setMinResolutionScale(context.minResolutionScale);
+
 	mBroadcastText.setFont(context.fonts->get(Fonts::Main));
 	mBroadcastText.setPosition(1024.f / 2, 100.f);
 
@@ -48,38 +69,23 @@ MultiplayerGameState::MultiplayerGameState(StateStack& stack, Context context, b
 	mPlayerInvitationText.setString("Press Enter to spawn player 2");
 	mPlayerInvitationText.setPosition(1000 - mPlayerInvitationText.getLocalBounds().width, 760 - mPlayerInvitationText.getLocalBounds().height);
 
-	// We reuse this text for "Attempt to connect" and "Failed to connect" messages
+	// We reuse this text for the connection progress and "Failed to connect" messages
 	mFailedConnectionText.setFont(context.fonts->get(Fonts::Main));
-	mFailedConnectionText.setString("Attempting to connect...");
 	mFailedConnectionText.setCharacterSize(35);
 	mFailedConnectionText.setColor(sf::Color::White);
-	centerOrigin(mFailedConnectionText);
-	mFailedConnectionText.setPosition(mWindow.getSize().x / 2.f, mWindow.getSize().y / 2.f);
+	setConnectionText("Resolving server address...");
 
-	// Render a "establishing connection" frame for user feedback
-	mWindow.clear(sf::Color::Black);
-	mWindow.draw(mFailedConnectionText);
-	mWindow.display();
-	mFailedConnectionText.setString("Could not connect to the remote server!");
-	centerOrigin(mFailedConnectionText);
-
-	sf::IpAddress ip;
 	if (isHost)
 	{
+		// The host talks to its own server in memory, other players connect over sockets
 		mGameServer.reset(new GameServer(sf::Vector2f(mWindow.getSize())));
-		ip = "127.0.0.1";
+		mConnection = mGameServer->connectLocal();
 	}
 	else
 	{
-		ip = getAddressFromFile();
+		// Resolving and connecting happen on the connection's network thread
+		mConnection.reset(new RemoteConnection(getAddressFromFile(), ServerPort, ConnectTimeout));
 	}
-	
-	if (mSocket.connect(ip, ServerPort, sf::seconds(5.f)) == sf::TcpSocket::Done)
-		mConnected = true;
-	else
-		mFailedConnectionClock.restart();
-
-	mSocket.setBlocking(false);
 
 	// Play game theme
 	context.music->play(Music::MissionTheme);
@@ -87,7 +93,7 @@ MultiplayerGameState::MultiplayerGameState(StateStack& stack, Context context, b
 
 void MultiplayerGameState::draw()
 {
-	if (mConnected)
+	if (mConnectionPhase == Connected)
 	{
 		mWorld.draw();
 
@@ -111,21 +117,36 @@ void MultiplayerGameState::onActivate()
 	mActiveState = true;
 }
 
+void MultiplayerGameState::setInterpolation(float alpha)
+{
+	mWorld.setInterpolation(alpha);
+}
+
 void MultiplayerGameState::onDestroy()
 {
-	if (!mHost && mConnected)
+	if (!mHost && (mConnectionPhase == Handshaking || mConnectionPhase == Connected))
 	{
 		// Inform server this client is dying
 		sf::Packet packet;
 		packet << static_cast<sf::Int32>(Client::Quit);
-		mSocket.send(packet);
+		mConnection->send(packet);
 	}
+
+	getContext().statistics->removeValue("Connection");
+	getContext().statistics->removeValue("Packets");
+	getContext().statistics->removeValue("Network");
+}
+
+void MultiplayerGameState::setPacketBudget(std::size_t maxPackets, sf::Time maxTime)
+{
+	mPacketBudget = maxPackets;
+	mPacketTimeBudget = maxTime;
 }
 
 bool MultiplayerGameState::update(sf::Time dt)
 {
 	// Connected to server: Handle all the network logic
-	if (mConnected)
+	if (mConnectionPhase == Connected)
 	{
 		mWorld.update(dt);
 
@@ -172,26 +193,15 @@ bool MultiplayerGameState::update(sf::Time dt)
 			pair.second->handleRealtimeNetworkInput(commands);
 
 		// Handle messages from server that may have arrived
-		sf::Packet packet;
-		if (mSocket.receive(packet) == sf::Socket::Done)
+		if (receivePackets())
 		{
 			mTimeSinceLastPacket = sf::seconds(0.f);
-			sf::Int32 packetType;	
-			packet >> packetType;
-			handlePacket(packetType, packet);	
 		}
 		else
 		{
 			// Check for timeout with the server
-			if (mTimeSinceLastPacket > mClientTimeout)
-			{
-				mConnected = false;
-
-				mFailedConnectionText.setString("Lost connection to server");
-				centerOrigin(mFailedConnectionText);
-
-				mFailedConnectionClock.restart();
-			}
+			if (mTimeSinceLastPacket > mClientTimeout || mConnection->getStatus() == ServerConnection::Disconnected)
+				failConnection("Lost connection to server");
 		}
 
 		updateBroadcastMessage(dt);
@@ -211,7 +221,7 @@ bool MultiplayerGameState::update(sf::Time dt)
 			packet << gameAction.position.x;
 			packet << gameAction.position.y;
 
-			mSocket.send(packet);
+			mConnection->send(packet);
 		}
 
 		// Regular position updates
@@ -227,13 +237,19 @@ bool MultiplayerGameState::update(sf::Time dt)
 					positionUpdatePacket << identifier << aircraft->getPosition().x << aircraft->getPosition().y << static_cast<sf::Int32>(aircraft->getHitpoints()) << static_cast<sf::Int32>(aircraft->getMissileAmmo());
 			}
 
-			mSocket.send(positionUpdatePacket);
+			mConnection->send(positionUpdatePacket);
 			mTickClock.restart();
 		}
 
 		mTimeSinceLastPacket += dt;
 	}
 
+	// Still setting up the connection
+	else if (mConnectionPhase != Disconnected)
+	{
+		updateConnection();
+	}
+
 	// Failed to connect and waited for more than 5 seconds: Back to menu
 	else if (mFailedConnectionClock.getElapsedTime() >= sf::seconds(5.f))
 	{
@@ -254,6 +270,18 @@ void MultiplayerGameState::disableAllRealtimeActions()
 
 bool MultiplayerGameState::handleEvent(const sf::Event& event)
 {
+	// Escape cancels the connection attempt, or skips the failure message
+	if (mConnectionPhase != Connected)
+	{
+		if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::Escape)
+		{
+			requestStateClear();
+			requestStackPush(States::Menu);
+		}
+
+		return true;
+	}
+
 	// Game input handling
 	CommandQueue& commands = mWorld.getCommandQueue();
 
@@ -269,7 +297,7 @@ bool MultiplayerGameState::handleEvent(const sf::Event& event)
 			sf::Packet packet;
 			packet << static_cast<sf::Int32>(Client::RequestCoopPartner);
 
-			mSocket.send(packet);
+			mConnection->send(packet);
 		}
 
 		// Escape pressed, trigger the pause screen
@@ -343,7 +371,8 @@ void MultiplayerGameState::handlePacket(sf::Int32 packetType, sf::Packet& packet
 			Aircraft* aircraft = mWorld.addAircraft(aircraftIdentifier);
 			aircraft->setPosition(aircraftPosition);
 			
-			mPlayers[aircraftIdentifier].reset(new Player(&mSocket, aircraftIdentifier, getContext().keys1));
+			mPlayers[aircraftIdentifier].reset(new Player(mConnection.get(), aircraftIdentifier, getContext().keys1));
+			mPlayers[aircraftIdentifier]->setAircraft(mWorld.getAircraftHandle(aircraftIdentifier));
 			mLocalPlayerIdentifiers.push_back(aircraftIdentifier);
 
 			mGameStarted = true;
@@ -359,7 +388,8 @@ void MultiplayerGameState::handlePacket(sf::Int32 packetType, sf::Packet& packet
 			Aircraft* aircraft = mWorld.addAircraft(aircraftIdentifier);
 			aircraft->setPosition(aircraftPosition);
 
-			mPlayers[aircraftIdentifier].reset(new Player(&mSocket, aircraftIdentifier, nullptr));
+			mPlayers[aircraftIdentifier].reset(new Player(mConnection.get(), aircraftIdentifier, nullptr));
+			mPlayers[aircraftIdentifier]->setAircraft(mWorld.getAircraftHandle(aircraftIdentifier));
 		} break;
 
 		// 
@@ -378,6 +408,7 @@ void MultiplayerGameState::handlePacket(sf::Int32 packetType, sf::Packet& packet
 			sf::Int32 aircraftCount;
 			float worldHeight, currentScroll;
 			packet >> worldHeight >> currentScroll;
+			mReceivedInitialState = true;
 
 			mWorld.setWorldHeight(worldHeight);
 			mWorld.setCurrentBattleFieldPosition(currentScroll);
@@ -396,7 +427,8 @@ void MultiplayerGameState::handlePacket(sf::Int32 packetType, sf::Packet& packet
 				aircraft->setHitpoints(hitpoints);
 				aircraft->setMissileAmmo(missileAmmo);
 
-				mPlayers[aircraftIdentifier].reset(new Player(&mSocket, aircraftIdentifier, nullptr));
+				mPlayers[aircraftIdentifier].reset(new Player(mConnection.get(), aircraftIdentifier, nullptr));
+				mPlayers[aircraftIdentifier]->setAircraft(mWorld.getAircraftHandle(aircraftIdentifier));
 			}
 		} break;
 
@@ -407,7 +439,8 @@ void MultiplayerGameState::handlePacket(sf::Int32 packetType, sf::Packet& packet
 			packet >> aircraftIdentifier;
 
 			mWorld.addAircraft(aircraftIdentifier);
-			mPlayers[aircraftIdentifier].reset(new Player(&mSocket, aircraftIdentifier, getContext().keys2));
+			mPlayers[aircraftIdentifier].reset(new Player(mConnection.get(), aircraftIdentifier, getContext().keys2));
+			mPlayers[aircraftIdentifier]->setAircraft(mWorld.getAircraftHandle(aircraftIdentifier));
 			mLocalPlayerIdentifiers.push_back(aircraftIdentifier);
 		} break;
 
@@ -445,7 +478,6 @@ void MultiplayerGameState::handlePacket(sf::Int32 packetType, sf::Packet& packet
 			packet >> type >> height >> relativeX;
 
 			mWorld.addEnemy(static_cast<Aircraft::Type>(type), relativeX, height);
-			mWorld.sortEnemies();
 		} break;
 
 		// Mission successfully completed
@@ -493,3 +525,122 @@ void MultiplayerGameState::handlePacket(sf::Int32 packetType, sf::Packet& packet
 		} break;
 	}
 }
+
+bool MultiplayerGameState::receivePackets()
+{
+	sf::Clock budgetClock;
+
+	// Handle messages in arrival order until the frame's budget is spent, the rest waits for the next frame
+	std::size_t processed = 0;
+	sf::Time delay;
+	while (processed < mPacketBudget && budgetClock.getElapsedTime() < mPacketTimeBudget && mConnection->pollMessage(mMessage))
+	{
+		// Time between arrival on the network thread and handling here
+		delay = mConnection->now() - mMessage.arrivalTime;
+		handlePacket(mMessage.type, mMessage.packet);
+		++processed;
+	}
+
+	std::size_t queueDepth = mConnection->getPendingMessageCount();
+	mPeakPacketQueueDepth = std::max(mPeakPacketQueueDepth, queueDepth);
+	mPeakPacketDelay = std::max(mPeakPacketDelay, delay);
+	getContext().statistics->setValue("Packets", toString(processed) + " handled, " + toString(queueDepth) + " queued (peak "
+		+ toString(mPeakPacketQueueDepth) + "), delay " + toString(delay.asMilliseconds()) + " ms (peak " + toString(mPeakPacketDelay.asMilliseconds()) + " ms)");
+
+	updateTrafficStatistics();
+
+	return processed > 0;
+}
+
+void MultiplayerGameState::updateTrafficStatistics()
+{
+	// Averaged over a second, single packets would make the rate jump around
+	sf::Time elapsed = mTrafficClock.getElapsedTime();
+	if (elapsed < sf::seconds(1.f))
+		return;
+
+	mTrafficClock.restart();
+
+	std::size_t received = mConnection->getBytesReceived();
+	std::size_t sent = mConnection->getBytesSent();
+	float inRate = (received - mLastBytesReceived) / 1024.f / elapsed.asSeconds();
+	float outRate = (sent - mLastBytesSent) / 1024.f / elapsed.asSeconds();
+	mLastBytesReceived = received;
+	mLastBytesSent = sent;
+
+	getContext().statistics->setValue("Network", "in " + toString(static_cast<int>(inRate * 10.f) / 10.f) + " KB/s, out "
+		+ toString(static_cast<int>(outRate * 10.f) / 10.f) + " KB/s");
+}
+
+std::size_t MultiplayerGameState::getPacketQueueDepth() const
+{
+	return mConnection->getPendingMessageCount();
+}
+
+void MultiplayerGameState::updateConnection()
+{
+	sf::Time elapsed = mConnectionClock.getElapsedTime();
+
+	switch (mConnectionPhase)
+	{
+		case Resolving:
+		case Connecting:
+		{
+			ServerConnection::Status status = mConnection->getStatus();
+			if (status == ServerConnection::Connecting && mConnectionPhase == Resolving)
+			{
+				mConnectionPhase = Connecting;
+				setConnectionText("Attempting to connect...");
+			}
+			else if (status == ServerConnection::Connected)
+			{
+				mConnectTime = elapsed;
+				mConnectionPhase = Handshaking;
+				setConnectionText("Joining game...");
+			}
+			else if (status == ServerConnection::Disconnected)
+			{
+				failConnection("Could not connect to the remote server!");
+			}
+		} break;
+
+		case Handshaking:
+		{
+			// The server sends the world state and our own aircraft right after accepting
+			receivePackets();
+
+			if (mReceivedInitialState && mGameStarted)
+			{
+				mConnectionPhase = Connected;
+				mTimeSinceLastPacket = sf::Time::Zero;
+				mTickClock.restart();
+
+				getContext().statistics->setValue("Connection", "resolve " + toString(mConnection->getResolveTime().asMilliseconds()) + " ms, "
+					+ "connect " + toString(mConnection->getConnectTime().asMilliseconds()) + " ms (" + toString(mConnection->getConnectAttempts()) + " attempts), "
+					+ "handshake " + toString((elapsed - mConnectTime).asMilliseconds()) + " ms");
+			}
+			else if (elapsed >= mConnectTime + HandshakeTimeout || mConnection->getStatus() == ServerConnection::Disconnected)
+			{
+				failConnection("The server did not respond!");
+			}
+		} break;
+
+		default:
+			break;
+	}
+}
+
+void MultiplayerGameState::failConnection(const std::string& message)
+{
+	mConnectionPhase = Disconnected;
+
+	setConnectionText(message);
+	mFailedConnectionClock.restart();
+}
+
+void MultiplayerGameState::setConnectionText(const std::string& message)
+{
+	mFailedConnectionText.setString(message);
+	centerOrigin(mFailedConnectionText);
+	mFailedConnectionText.setPosition(mWindow.getSize().x / 2.f, mWindow.getSize().y / 2.f);
+}
@@ -1,30 +1,98 @@
 #include <Book/MusicPlayer.hpp>
+#include <Book/Foreach.hpp>
 
+#include <algorithm>
 
-MusicPlayer::MusicPlayer()
-: mMusic()
+
+namespace
+{
+	// Decoded samples kept per theme, so restarting a theme needs no decoding up front
+	const sf::Time CachedHeadDuration = sf::seconds(5.f);
+}
+
+MusicPlayer::MusicPlayer(ResourceLoader& loader, const AssetArchive& archive)
+: mLoader(loader)
+, mArchive(archive)
 , mFilenames()
+, mTracks()
+, mCurrentTheme()
+, mPendingTheme()
+, mHasCurrentTheme(false)
+, mHasPendingTheme(false)
+, mCrossfadeDuration(sf::seconds(1.5f))
 , mVolume(100.f)
+, mPaused(false)
 {
 	mFilenames[Music::MenuTheme]    = "Media/Music/MenuTheme.ogg";
 	mFilenames[Music::MissionTheme] = "Media/Music/MissionTheme.ogg";
 }
 
+void MusicPlayer::prefetch(Music::ID theme)
+{
+	getTrack(theme);
+}
+
 void MusicPlayer::play(Music::ID theme)
 {
-	std::string filename = mFilenames[theme];
+	if (mHasCurrentTheme && mCurrentTheme == theme && !mHasPendingTheme)
+		return;
 
-	if (!mMusic.openFromFile(filename))
-		throw std::runtime_error("Music " + filename + " could not be loaded.");
+	// Starts in update() once the track is opened; a failed open throws from ResourceLoader::update()
+	getTrack(theme);
+	mPendingTheme = theme;
+	mHasPendingTheme = true;
 
-	mMusic.setVolume(mVolume);
-	mMusic.setLoop(true);
-	mMusic.play();
+	update(sf::Time::Zero);
 }
 
 void MusicPlayer::stop()
 {
-	mMusic.stop();
+	FOREACH(auto& pair, mTracks)
+	{
+		pair.second.gain = 0.f;
+		if (pair.second.opened.isReady())
+			pair.second.music->stop();
+	}
+
+	mHasCurrentTheme = false;
+	mHasPendingTheme = false;
+}
+
+void MusicPlayer::update(sf::Time dt)
+{
+	if (mPaused)
+		return;
+
+	if (mHasPendingTheme && getTrack(mPendingTheme).opened.isReady())
+	{
+		start(mPendingTheme);
+		mHasPendingTheme = false;
+	}
+
+	// Fade the current theme in and all others out
+	float step = (mCrossfadeDuration > sf::Time::Zero) ? dt.asSeconds() / mCrossfadeDuration.asSeconds() : 1.f;
+
+	FOREACH(auto& pair, mTracks)
+	{
+		Track& track = pair.second;
+		if (!track.opened.isReady() || track.music->getStatus() == sf::Music::Stopped)
+			continue;
+
+		if (mHasCurrentTheme && pair.first == mCurrentTheme)
+		{
+			track.gain = std::min(1.f, track.gain + step);
+		}
+		else
+		{
+			track.gain = std::max(0.f, track.gain - step);
+
+			// Stopping rewinds the track, so its cached head plays when it starts again
+			if (track.gain == 0.f)
+				track.music->stop();
+		}
+
+		track.music->setVolume(mVolume * track.gain);
+	}
 }
 
 void MusicPlayer::setVolume(float volume)
@@ -32,10 +100,73 @@ void MusicPlayer::setVolume(float volume)
 	mVolume = volume;
 }
 
+void MusicPlayer::setCrossfadeDuration(sf::Time duration)
+{
+	mCrossfadeDuration = duration;
+}
+
 void MusicPlayer::setPaused(bool paused)
 {
-	if (paused)
-		mMusic.pause();
-	else
-		mMusic.play();
+	mPaused = paused;
+
+	FOREACH(auto& pair, mTracks)
+	{
+		Track& track = pair.second;
+		if (!track.opened.isReady() || track.music->getStatus() == sf::Music::Stopped)
+			continue;
+
+		if (paused)
+			track.music->pause();
+		else
+			track.music->play();
+	}
+}
+
+MusicPlayer::Track& MusicPlayer::getTrack(Music::ID theme)
+{
+	auto found = mTracks.find(theme);
+	if (found != mTracks.end())
+		return found->second;
+
+	// Open the stream in the background; the track object is shared with the job so it outlives us if needed
+	Track& track = mTracks[theme];
+	track.music = std::make_shared<MusicTrack>(CachedHeadDuration);
+	track.gain = 0.f;
+
+	std::shared_ptr<MusicTrack> music = track.music;
+	std::string filename = mFilenames[theme];
+	const AssetArchive& archive = mArchive;
+
+	track.opened = mLoader.enqueue(filename, [music, filename, &archive] ()
+	{
+		return music->open(filename, archive);
+	},
+	[] ()
+	{
+		return true;
+	});
+
+	return track;
+}
+
+void MusicPlayer::start(Music::ID theme)
+{
+	// Without another theme audible, there is nothing to crossfade from
+	bool crossfade = false;
+	FOREACH(auto& pair, mTracks)
+	{
+		if (pair.first != theme && pair.second.gain > 0.f)
+			crossfade = true;
+	}
+
+	Track& track = getTrack(theme);
+	if (track.music->getStatus() == sf::Music::Stopped)
+		track.gain = crossfade ? 0.f : 1.f;
+
+	track.music->setVolume(mVolume * track.gain);
+	track.music->setLoop(true);
+	track.music->play();
+
+	mCurrentTheme = theme;
+	mHasCurrentTheme = true;
 }
@@ -0,0 +1,100 @@
+#include <Book/MusicTrack.hpp>
+#include <Book/AssetArchive.hpp>
+
+#include <algorithm>
+
+
+MusicTrack::MusicTrack(sf::Time headDuration)
+: sf::Music()
+, mHeadDuration(headDuration)
+, mHead()
+, mHeadComplete(false)
+, mHeadIsWholeTrack(false)
+, mCapturing(true)
+, mServingHead(false)
+, mHeadPosition(0)
+{
+}
+
+bool MusicTrack::open(const std::string& filename, const AssetArchive& archive)
+{
+	// Packed tracks are streamed directly from the archive's mapping
+	const AssetArchive::Entry* entry = archive.find(filename);
+	if (entry)
+		return openFromMemory(entry->data, entry->size);
+
+	return openFromFile(filename);
+}
+
+bool MusicTrack::onGetData(Chunk& data)
+{
+	// All the methods below run on the streaming thread, or while it is stopped
+	if (mServingHead)
+	{
+		// Hand out the cache in one-second chunks, like sf::Music does
+		std::size_t chunkSize = getSampleRate() * getChannelCount();
+		data.samples = &mHead[mHeadPosition];
+		data.sampleCount = std::min(chunkSize, mHead.size() - mHeadPosition);
+		mHeadPosition += data.sampleCount;
+
+		if (mHeadPosition < mHead.size())
+			return true;
+
+		mServingHead = false;
+		if (mHeadIsWholeTrack)
+			return false;
+
+		// Continue decoding right behind the cached samples
+		sf::Music::onSeek(getHeadDuration());
+		return true;
+	}
+
+	bool more = sf::Music::onGetData(data);
+
+	if (mCapturing && !mHeadComplete)
+	{
+		std::size_t capacity = static_cast<std::size_t>(mHeadDuration.asSeconds() * getSampleRate()) * getChannelCount();
+		std::size_t count = std::min(data.sampleCount, capacity - mHead.size());
+		mHead.insert(mHead.end(), data.samples, data.samples + count);
+
+		if (mHead.size() >= capacity || !more)
+		{
+			mHeadComplete = true;
+			mHeadIsWholeTrack = !more && count == data.sampleCount;
+		}
+	}
+
+	return more;
+}
+
+void MusicTrack::onSeek(sf::Time timeOffset)
+{
+	if (mHeadComplete && timeOffset < getHeadDuration())
+	{
+		// The decoder is repositioned once the cache is used up
+		std::size_t frame = static_cast<std::size_t>(timeOffset.asSeconds() * getSampleRate());
+		mHeadPosition = std::min(frame * getChannelCount(), mHead.size());
+		mServingHead = mHeadPosition < mHead.size();
+
+		if (!mServingHead && !mHeadIsWholeTrack)
+			sf::Music::onSeek(timeOffset);
+
+		return;
+	}
+
+	// Capture only while decoding contiguously from the start
+	mServingHead = false;
+	if (!mHeadComplete)
+	{
+		mHead.clear();
+		mCapturing = (timeOffset == sf::Time::Zero);
+	}
+
+	sf::Music::onSeek(timeOffset);
+}
+
+sf::Time MusicTrack::getHeadDuration() const
+{
+	std::size_t frames = mHead.size() / getChannelCount();
+	return sf::microseconds(static_cast<sf::Int64>(frames) * 1000000 / getSampleRate());
+}
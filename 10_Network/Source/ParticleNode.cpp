@@ -1,5 +1,4 @@
 #include <Book/ParticleNode.hpp>
-#include <Book/Foreach.hpp>
 #include <Book/DataTables.hpp>
 #include <Book/ResourceHolder.hpp>
 
@@ -7,31 +6,89 @@
 #include <SFML/Graphics/Texture.hpp>
 
 #include <algorithm>
+#include <cassert>
 
 
 namespace
 {
 	const std::vector<ParticleData> Table = initializeParticleData();
+
+	// Kernels work on plain contiguous arrays without branches, so that the compiler can vectorize them
+	void computeFade(const float* expiryTimes, std::size_t count, float now, float inverseLifetime, float* fadeFactors)
+	{
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			float ratio = (expiryTimes[i] - now) * inverseLifetime;
+			fadeFactors[i] = 255.f * std::min(std::max(ratio, 0.f), 1.f);
+		}
+	}
+
+	void computeQuads(const float* positionsX, const float* positionsY, const float* fadeFactors, std::size_t count,
+		sf::Vector2f half, sf::Color color, sf::Vertex* vertices)
+	{
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			color.a = static_cast<sf::Uint8>(fadeFactors[i]);
+
+			sf::Vertex* quad = vertices + 4 * i;
+			quad[0].position = sf::Vector2f(positionsX[i] - half.x, positionsY[i] - half.y);
+			quad[1].position = sf::Vector2f(positionsX[i] + half.x, positionsY[i] - half.y);
+			quad[2].position = sf::Vector2f(positionsX[i] + half.x, positionsY[i] + half.y);
+			quad[3].position = sf::Vector2f(positionsX[i] - half.x, positionsY[i] + half.y);
+
+			quad[0].color = color;
+			quad[1].color = color;
+			quad[2].color = color;
+			quad[3].color = color;
+		}
+	}
 }
 
 ParticleNode::ParticleNode(Particle::Type type, const TextureHolder& textures)
 : SceneNode()
-, mParticles()
+, mPositionsX(Table[type].capacity)
+, mPositionsY(Table[type].capacity)
+, mExpiryTimes(Table[type].capacity)
+, mFirst(0)
+, mCount(0)
+, mElapsedTime(0.f)
 , mTexture(textures.get(Textures::Particle))
 , mType(type)
-, mVertexArray(sf::Quads)
+, mColor(Table[type].color)
+, mLifetime(Table[type].lifetime.asSeconds())
+, mFadeFactors(Table[type].capacity)
+, mVertices(4 * Table[type].capacity)
 , mNeedsVertexUpdate(true)
 {
+	assert(Table[type].capacity > 0);
+
+	// Texture coordinates are the same for every quad, set them once
+	sf::Vector2f size(mTexture.getSize());
+	for (std::size_t i = 0; i < mVertices.size(); i += 4)
+	{
+		mVertices[i + 0].texCoords = sf::Vector2f(0.f,    0.f);
+		mVertices[i + 1].texCoords = sf::Vector2f(size.x, 0.f);
+		mVertices[i + 2].texCoords = sf::Vector2f(size.x, size.y);
+		mVertices[i + 3].texCoords = sf::Vector2f(0.f,    size.y);
+	}
 }
 
 void ParticleNode::addParticle(sf::Vector2f position)
 {
-	Particle particle;
-	particle.position = position;
-	particle.color = Table[mType].color;
-	particle.lifetime = Table[mType].lifetime;
+	std::size_t capacity = mExpiryTimes.size();
+
+	// Buffer full: the oldest particle makes room for the new one
+	if (mCount == capacity)
+	{
+		mFirst = (mFirst + 1) % capacity;
+		--mCount;
+	}
 
-	mParticles.push_back(particle);
+	std::size_t index = (mFirst + mCount) % capacity;
+	mPositionsX[index] = position.x;
+	mPositionsY[index] = position.y;
+	mExpiryTimes[index] = mElapsedTime + mLifetime;
+	++mCount;
 }
 
 Particle::Type ParticleNode::getParticleType() const
@@ -39,6 +96,11 @@ Particle::Type ParticleNode::getParticleType() const
 	return mType;
 }
 
+std::size_t ParticleNode::getParticleCount() const
+{
+	return mCount;
+}
+
 unsigned int ParticleNode::getCategory() const
 {
 	return Category::ParticleSystem;	
@@ -46,19 +108,31 @@ unsigned int ParticleNode::getCategory() const
 
 void ParticleNode::updateCurrent(sf::Time dt, CommandQueue&)
 {
-	// Remove expired particles at beginning
-	while (!mParticles.empty() && mParticles.front().lifetime <= sf::Time::Zero)
-		mParticles.pop_front();
+	mElapsedTime += dt.asSeconds();
+
+	// All particles share the same lifetime, so they expire in emission order: remove them at the front
+	std::size_t capacity = mExpiryTimes.size();
+	while (mCount > 0 && mExpiryTimes[mFirst] <= mElapsedTime)
+	{
+		mFirst = (mFirst + 1) % capacity;
+		--mCount;
+	}
 
-	// Decrease lifetime of existing particles
-	FOREACH(Particle& particle, mParticles)
-		particle.lifetime -= dt;
+	// Restart the clock whenever the system is empty, to keep float precision in long sessions
+	if (mCount == 0)
+	{
+		mFirst = 0;
+		mElapsedTime = 0.f;
+	}
 
 	mNeedsVertexUpdate = true;
 }
 
 void ParticleNode::drawCurrent(sf::RenderTarget& target, sf::RenderStates states) const
 {
+	if (mCount == 0)
+		return;
+
 	if (mNeedsVertexUpdate)
 	{
 		computeVertices();
@@ -68,38 +142,45 @@ void ParticleNode::drawCurrent(sf::RenderTarget& target, sf::RenderStates states
 	// Apply particle texture
 	states.texture = &mTexture;
 	
-	// Draw vertices
-	target.draw(mVertexArray, states);
+	// Draw vertices of alive particles
+	target.draw(&mVertices[0], static_cast<unsigned int>(4 * mCount), sf::Quads, states);
 }
 
-void ParticleNode::addVertex(float worldX, float worldY, float texCoordX, float texCoordY, const sf::Color& color) const
+void ParticleNode::rebase(sf::Vector2f offset)
 {
-	sf::Vertex vertex;
-	vertex.position = sf::Vector2f(worldX, worldY);
-	vertex.texCoords = sf::Vector2f(texCoordX, texCoordY);
-	vertex.color = color;
+	// The node stays at the origin, particles are stored in world coordinates
+	for (std::size_t i = 0; i < mPositionsX.size(); ++i)
+	{
+		mPositionsX[i] += offset.x;
+		mPositionsY[i] += offset.y;
+	}
 
-	mVertexArray.append(vertex);
+	mNeedsVertexUpdate = true;
+}
+
+void ParticleNode::collectCurrentStatistics(SceneStatistics& statistics) const
+{
+	statistics.particles += mCount;
+	if (mCount > 0)
+		++statistics.drawCalls;
 }
 
 void ParticleNode::computeVertices() const
 {
-	sf::Vector2f size(mTexture.getSize());
-	sf::Vector2f half = size / 2.f;
+	// The alive particles occupy at most two contiguous segments of the ring buffer
+	std::size_t firstCount = std::min(mCount, mExpiryTimes.size() - mFirst);
 
-	// Refill vertex array
-	mVertexArray.clear();
-	FOREACH(const Particle& particle, mParticles)
-	{
-		sf::Vector2f pos = particle.position;
-		sf::Color color = particle.color;
+	computeSegment(mFirst, firstCount, 0);
+	computeSegment(0, mCount - firstCount, firstCount);
+}
+
+void ParticleNode::computeSegment(std::size_t first, std::size_t count, std::size_t outputOffset) const
+{
+	if (count == 0)
+		return;
 
-		float ratio = particle.lifetime.asSeconds() / Table[mType].lifetime.asSeconds();
-		color.a = static_cast<sf::Uint8>(255 * std::max(ratio, 0.f));
+	sf::Vector2f half = sf::Vector2f(mTexture.getSize()) / 2.f;
 
-		addVertex(pos.x - half.x, pos.y - half.y, 0.f,    0.f,    color);
-		addVertex(pos.x + half.x, pos.y - half.y, size.x, 0.f,    color);
-		addVertex(pos.x + half.x, pos.y + half.y, size.x, size.y, color);
-		addVertex(pos.x - half.x, pos.y + half.y, 0.f,    size.y, color);
-	}
+	computeFade(&mExpiryTimes[first], count, mElapsedTime, 1.f / mLifetime, &mFadeFactors[outputOffset]);
+	computeQuads(&mPositionsX[first], &mPositionsY[first], &mFadeFactors[outputOffset], count, half, mColor, &mVertices[4 * outputOffset]);
 }
@@ -0,0 +1,238 @@
+#include <Book/PerformanceOverlay.hpp>
+#include <Book/Statistics.hpp>
+#include <Book/Utility.hpp>
+#include <Book/Foreach.hpp>
+
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/Font.hpp>
+#include <SFML/Graphics/Glyph.hpp>
+
+#include <algorithm>
+#include <cassert>
+
+
+namespace
+{
+	const std::size_t HistorySize = 2048;
+	const std::size_t GraphFrames = 240;
+	const unsigned int CharacterSize = 10;
+
+	const sf::Vector2f Origin(5.f, 5.f);
+	const float BarWidth = 2.f;
+	const float GraphHeight = 80.f;
+	const float Padding = 4.f;
+	const sf::Time GraphRange = sf::milliseconds(50);
+	const sf::Time TextInterval = sf::seconds(0.25f);
+
+	// Frames up to 60 FPS are green, up to 30 FPS yellow, slower ones red
+	const sf::Time FastFrame = sf::microseconds(16667);
+	const sf::Time SlowFrame = sf::microseconds(33333);
+
+	const sf::Color BackgroundColor(0, 0, 0, 160);
+	const sf::Color MarkerColor(255, 255, 255, 96);
+	const sf::Color TextColor(sf::Color::White);
+
+	// Every font page starts with a small white square, sampling it gives solid colors
+	const sf::Vector2f WhiteTexel(1.f, 1.f);
+
+	float toMilliseconds(sf::Time time)
+	{
+		return static_cast<int>(time.asMicroseconds() / 100) / 10.f;
+	}
+
+	float toFramesPerSecond(sf::Time frameTime)
+	{
+		return frameTime > sf::Time::Zero ? static_cast<int>(1.f / frameTime.asSeconds()) : 0.f;
+	}
+}
+
+PerformanceOverlay::PerformanceOverlay(const Statistics& statistics)
+: mFont(nullptr)
+, mStatistics(statistics)
+, mVisible(false)
+, mFrameTimes(HistorySize)
+, mNextFrame(0)
+, mFrameCount(0)
+, mTextElapsedTime()
+, mUpdateTime()
+, mRenderTime()
+, mTextFrames(0)
+, mTextVertices()
+, mVertices()
+{
+}
+
+void PerformanceOverlay::setFont(const sf::Font& font)
+{
+	mFont = &font;
+}
+
+void PerformanceOverlay::setVisible(bool visible)
+{
+	mVisible = visible;
+
+	// Show the current state right away instead of after the next interval
+	if (mVisible)
+		mTextElapsedTime = TextInterval;
+}
+
+bool PerformanceOverlay::isVisible() const
+{
+	return mVisible;
+}
+
+void PerformanceOverlay::addFrame(sf::Time frameTime, sf::Time updateTime, sf::Time renderTime)
+{
+	mFrameTimes[mNextFrame] = frameTime;
+	mNextFrame = (mNextFrame + 1) % mFrameTimes.size();
+	mFrameCount = std::min(mFrameCount + 1, mFrameTimes.size());
+
+	mTextElapsedTime += frameTime;
+	mUpdateTime += updateTime;
+	mRenderTime += renderTime;
+	mTextFrames += 1;
+
+	// Nothing is built while hidden
+	if (!mVisible || !mFont)
+		return;
+
+	// Text layout and percentiles cost more than the graph, refresh them a few times per second
+	if (mTextElapsedTime >= TextInterval)
+	{
+		buildText();
+
+		mTextElapsedTime = sf::Time::Zero;
+		mUpdateTime = sf::Time::Zero;
+		mRenderTime = sf::Time::Zero;
+		mTextFrames = 0;
+	}
+
+	buildVertices();
+}
+
+void PerformanceOverlay::draw(sf::RenderTarget& target, sf::RenderStates states) const
+{
+	if (!mVisible || !mFont || mVertices.empty())
+		return;
+
+	states.texture = &mFont->getTexture(CharacterSize);
+	target.draw(&mVertices[0], static_cast<unsigned int>(mVertices.size()), sf::Quads, states);
+}
+
+void PerformanceOverlay::buildText()
+{
+	std::size_t frames = std::max<std::size_t>(mTextFrames, 1);
+	sf::Time averageFrame = mTextElapsedTime / static_cast<sf::Int64>(frames);
+
+	// Lows are the frame rates that 1% and 0.1% of the recorded frames fall below
+	std::string text = "FPS: " + toString(toFramesPerSecond(averageFrame))
+		+ ", 1% low: " + toString(toFramesPerSecond(getPercentileFrameTime(0.99f)))
+		+ ", 0.1% low: " + toString(toFramesPerSecond(getPercentileFrameTime(0.999f)))
+		+ "\nFrame: " + toString(toMilliseconds(averageFrame)) + " ms"
+		+ ", update: " + toString(toMilliseconds(mUpdateTime / static_cast<sf::Int64>(frames))) + " ms"
+		+ ", render: " + toString(toMilliseconds(mRenderTime / static_cast<sf::Int64>(frames))) + " ms"
+		+ "\n" + mStatistics.getText();
+
+	// The background quad comes first and is sized once the text is laid out
+	mTextVertices.clear();
+	appendRect(mTextVertices, sf::FloatRect(), BackgroundColor);
+
+	sf::Vector2f position(Origin.x, Origin.y + GraphHeight + 2.f * Padding);
+	sf::Vector2f size = appendText(mTextVertices, text, position + sf::Vector2f(Padding, Padding));
+
+	sf::FloatRect background(position.x, position.y, size.x + 2.f * Padding, size.y + 2.f * Padding);
+	mTextVertices[0].position = sf::Vector2f(background.left, background.top);
+	mTextVertices[1].position = sf::Vector2f(background.left + background.width, background.top);
+	mTextVertices[2].position = sf::Vector2f(background.left + background.width, background.top + background.height);
+	mTextVertices[3].position = sf::Vector2f(background.left, background.top + background.height);
+}
+
+void PerformanceOverlay::buildVertices()
+{
+	mVertices.clear();
+
+	float graphWidth = GraphFrames * BarWidth;
+	appendRect(mVertices, sf::FloatRect(Origin.x, Origin.y, graphWidth + 2.f * Padding, GraphHeight + 2.f * Padding), BackgroundColor);
+
+	// Newest frame on the right, bars grow upwards from the bottom edge
+	float bottom = Origin.y + Padding + GraphHeight;
+	std::size_t frames = std::min(mFrameCount, GraphFrames);
+	for (std::size_t i = 0; i < frames; ++i)
+	{
+		sf::Time frameTime = mFrameTimes[(mNextFrame + mFrameTimes.size() - 1 - i) % mFrameTimes.size()];
+		float height = std::min(frameTime.asSeconds() / GraphRange.asSeconds(), 1.f) * GraphHeight;
+		float left = Origin.x + Padding + graphWidth - (i + 1) * BarWidth;
+
+		sf::Color color = frameTime <= FastFrame ? sf::Color::Green : frameTime <= SlowFrame ? sf::Color::Yellow : sf::Color::Red;
+		appendRect(mVertices, sf::FloatRect(left, bottom - height, BarWidth, height), color);
+	}
+
+	// 60 and 30 FPS marker lines
+	appendRect(mVertices, sf::FloatRect(Origin.x + Padding, bottom - FastFrame.asSeconds() / GraphRange.asSeconds() * GraphHeight, graphWidth, 1.f), MarkerColor);
+	appendRect(mVertices, sf::FloatRect(Origin.x + Padding, bottom - SlowFrame.asSeconds() / GraphRange.asSeconds() * GraphHeight, graphWidth, 1.f), MarkerColor);
+
+	mVertices.insert(mVertices.end(), mTextVertices.begin(), mTextVertices.end());
+}
+
+sf::Time PerformanceOverlay::getPercentileFrameTime(float percentile) const
+{
+	if (mFrameCount == 0)
+		return sf::Time::Zero;
+
+	// Partial sort on a copy, the ring keeps its order for the graph
+	std::vector<sf::Time> frameTimes(mFrameTimes.begin(), mFrameTimes.begin() + mFrameCount);
+	std::size_t index = std::min(static_cast<std::size_t>(percentile * mFrameCount), mFrameCount - 1);
+	std::nth_element(frameTimes.begin(), frameTimes.begin() + index, frameTimes.end());
+
+	return frameTimes[index];
+}
+
+void PerformanceOverlay::appendRect(std::vector<sf::Vertex>& vertices, sf::FloatRect rect, sf::Color color) const
+{
+	vertices.push_back(sf::Vertex(sf::Vector2f(rect.left, rect.top), color, WhiteTexel));
+	vertices.push_back(sf::Vertex(sf::Vector2f(rect.left + rect.width, rect.top), color, WhiteTexel));
+	vertices.push_back(sf::Vertex(sf::Vector2f(rect.left + rect.width, rect.top + rect.height), color, WhiteTexel));
+	vertices.push_back(sf::Vertex(sf::Vector2f(rect.left, rect.top + rect.height), color, WhiteTexel));
+}
+
+sf::Vector2f PerformanceOverlay::appendText(std::vector<sf::Vertex>& vertices, const std::string& text, sf::Vector2f position) const
+{
+	assert(mFont);
+
+	// Same layout as sf::Text without kerning, which is irrelevant at this size
+	float lineSpacing = static_cast<float>(mFont->getLineSpacing(CharacterSize));
+	sf::Vector2f pen(0.f, static_cast<float>(CharacterSize));
+	float width = 0.f;
+
+	FOREACH(char character, text)
+	{
+		if (character == '\n')
+		{
+			pen.x = 0.f;
+			pen.y += lineSpacing;
+			continue;
+		}
+
+		const sf::Glyph& glyph = mFont->getGlyph(static_cast<sf::Uint8>(character), CharacterSize, false);
+
+		float left = position.x + pen.x + glyph.bounds.left;
+		float top = position.y + pen.y + glyph.bounds.top;
+		float right = left + glyph.bounds.width;
+		float bottom = top + glyph.bounds.height;
+
+		float u1 = static_cast<float>(glyph.textureRect.left);
+		float v1 = static_cast<float>(glyph.textureRect.top);
+		float u2 = static_cast<float>(glyph.textureRect.left + glyph.textureRect.width);
+		float v2 = static_cast<float>(glyph.textureRect.top + glyph.textureRect.height);
+
+		vertices.push_back(sf::Vertex(sf::Vector2f(left, top), TextColor, sf::Vector2f(u1, v1)));
+		vertices.push_back(sf::Vertex(sf::Vector2f(right, top), TextColor, sf::Vector2f(u2, v1)));
+		vertices.push_back(sf::Vertex(sf::Vector2f(right, bottom), TextColor, sf::Vector2f(u2, v2)));
+		vertices.push_back(sf::Vertex(sf::Vector2f(left, bottom), TextColor, sf::Vector2f(u1, v2)));
+
+		pen.x += glyph.advance;
+		width = std::max(width, pen.x);
+	}
+
+	return sf::Vector2f(width, pen.y + lineSpacing - CharacterSize);
+}
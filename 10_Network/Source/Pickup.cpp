@@ -41,3 +41,8 @@ void Pickup::drawCurrent(sf::RenderTarget& target, sf::RenderStates states) cons
 	target.draw(mSprite, states);
 }
 
+void Pickup::collectCurrentStatistics(SceneStatistics& statistics) const
+{
+	++statistics.drawCalls;
+}
+
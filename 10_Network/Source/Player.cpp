@@ -3,6 +3,7 @@
 #include <Book/Aircraft.hpp>
 #include <Book/Foreach.hpp>
 #include <Book/NetworkProtocol.hpp>
+#include <Book/ServerConnection.hpp>
 
 #include <SFML/Network/Packet.hpp>
 
@@ -64,11 +65,11 @@ struct AircraftMissileTrigger
 };
 
 
-Player::Player(sf::TcpSocket* socket, sf::Int32 identifier, const KeyBinding* binding)
+Player::Player(ServerConnection* connection, sf::Int32 identifier, const KeyBinding* binding)
 : mKeyBinding(binding)
 , mCurrentMissionStatus(MissionRunning)
 , mIdentifier(identifier)
-, mSocket(socket)
+, mConnection(connection)
 {
 	// Set initial action bindings
 	initializeActions();
@@ -87,13 +88,13 @@ void Player::handleEvent(const sf::Event& event, CommandQueue& commands)
 		if (mKeyBinding && mKeyBinding->checkAction(event.key.code, action) && !isRealtimeAction(action))
 		{
 			// Network connected -> send event over network
-			if (mSocket)
+			if (mConnection)
 			{
 				sf::Packet packet;
 				packet << static_cast<sf::Int32>(Client::PlayerEvent);
 				packet << mIdentifier;
 				packet << static_cast<sf::Int32>(action);		
-				mSocket->send(packet);
+				mConnection->send(packet);
 			}
 
 			// Network disconnected -> local event
@@ -105,7 +106,7 @@ void Player::handleEvent(const sf::Event& event, CommandQueue& commands)
 	}
 
 	// Realtime change (network connected)
-	if ((event.type == sf::Event::KeyPressed || event.type == sf::Event::KeyReleased) && mSocket)
+	if ((event.type == sf::Event::KeyPressed || event.type == sf::Event::KeyReleased) && mConnection)
 	{
 		Action action;
 		if (mKeyBinding && mKeyBinding->checkAction(event.key.code, action) && isRealtimeAction(action))
@@ -116,11 +117,17 @@ void Player::handleEvent(const sf::Event& event, CommandQueue& commands)
 			packet << mIdentifier;
 			packet << static_cast<sf::Int32>(action);
 			packet << (event.type == sf::Event::KeyPressed);
-			mSocket->send(packet);
+			mConnection->send(packet);
 		}
 	}
 }
 
+void Player::setAircraft(Handle aircraft)
+{
+	FOREACH(auto& pair, mActionBinding)
+		pair.second.target = aircraft;
+}
+
 bool Player::isLocal() const
 {
 	// No key binding means this player is remote
@@ -136,14 +143,14 @@ void Player::disableAllRealtimeActions()
 		packet << mIdentifier;
 		packet << static_cast<sf::Int32>(action.first);
 		packet << false;
-		mSocket->send(packet);
+		mConnection->send(packet);
 	}
 }
 
 void Player::handleRealtimeInput(CommandQueue& commands)
 {
 	// Check if this is a networked game and local player or just a single player game
-	if ((mSocket && isLocal()) || !mSocket)
+	if ((mConnection && isLocal()) || !mConnection)
 	{
 		// Lookup all actions and push corresponding commands to queue
 		std::vector<Action> activeActions = mKeyBinding->getRealtimeActions();
@@ -154,7 +161,7 @@ void Player::handleRealtimeInput(CommandQueue& commands)
 
 void Player::handleRealtimeNetworkInput(CommandQueue& commands)
 {
-	if (mSocket && !isLocal())
+	if (mConnection && !isLocal())
 	{
 		// Traverse all realtime input proxies. Because this is a networked game, the input isn't handled directly
 		FOREACH(auto pair, mActionProxies)
@@ -0,0 +1,56 @@
+#include <Book/PostEffectChain.hpp>
+#include <Book/RenderTargetPool.hpp>
+
+#include <SFML/Graphics/RenderTexture.hpp>
+#include <SFML/Graphics/Sprite.hpp>
+
+
+PostEffectChain::PostEffectChain(RenderTargetPool& renderTargets)
+: mRenderTargets(renderTargets)
+, mEffects()
+{
+}
+
+void PostEffectChain::addEffect(Ptr effect)
+{
+	mEffects.push_back(std::move(effect));
+}
+
+bool PostEffectChain::isEmpty() const
+{
+	return mEffects.empty();
+}
+
+void PostEffectChain::apply(const sf::RenderTexture& input, sf::RenderTarget& output)
+{
+	// No effects: pass input through, stretched to the output size
+	if (mEffects.empty())
+	{
+		sf::Sprite sprite(input.getTexture());
+		sprite.setScale(
+			static_cast<float>(output.getSize().x) / input.getSize().x,
+			static_cast<float>(output.getSize().y) / input.getSize().y);
+
+		output.draw(sprite);
+		return;
+	}
+
+	// Every effect but the last one renders into an intermediate target, which is the input of the next effect
+	const sf::RenderTexture* current = &input;
+	for (std::size_t i = 0; i + 1 < mEffects.size(); ++i)
+	{
+		sf::RenderTexture& next = mRenderTargets.acquire(input.getSize(), false);
+		mEffects[i]->apply(*current, next);
+		next.display();
+
+		if (current != &input)
+			mRenderTargets.release(*current);
+
+		current = &next;
+	}
+
+	mEffects.back()->apply(*current, output);
+
+	if (current != &input)
+		mRenderTargets.release(*current);
+}
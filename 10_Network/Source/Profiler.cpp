@@ -0,0 +1,186 @@
+#include <Book/Profiler.hpp>
+#include <Book/Utility.hpp>
+
+#include <SFML/System/Clock.hpp>
+#include <SFML/System/Mutex.hpp>
+#include <SFML/System/Lock.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <memory>
+#include <vector>
+
+
+namespace
+{
+	// Per thread; older events are overwritten once a capture exceeds it
+	const std::size_t EventCapacity = 16384;
+
+	// Threads beyond this limit are not recorded
+	const std::size_t MaxThreads = 32;
+
+	struct Event
+	{
+		const char*					name;
+		sf::Int64					start;
+		sf::Int64					end;
+	};
+
+	struct ThreadBuffer
+	{
+		ThreadBuffer()
+		: events(EventCapacity)
+		, count(0)
+		, captureBegin(0)
+		, name()
+		{
+		}
+
+		std::vector<Event>			events;
+		std::atomic<std::size_t>	count;			// Written by the owning thread only
+		std::size_t					captureBegin;	// Guarded by registryMutex, as is name
+		std::string					name;
+	};
+
+	sf::Mutex registryMutex;
+	std::vector<std::unique_ptr<ThreadBuffer>> registry;
+
+	std::atomic<bool> capturing(false);
+	sf::Clock profileClock;
+
+	thread_local ThreadBuffer* threadBuffer = nullptr;
+
+	ThreadBuffer* getThreadBuffer()
+	{
+		if (threadBuffer)
+			return threadBuffer;
+
+		sf::Lock lock(registryMutex);
+		if (registry.size() >= MaxThreads)
+			return nullptr;
+
+		registry.push_back(std::unique_ptr<ThreadBuffer>(new ThreadBuffer()));
+		threadBuffer = registry.back().get();
+		threadBuffer->name = "Thread " + toString(registry.size());
+		return threadBuffer;
+	}
+
+	void writeEscaped(std::ostream& stream, const std::string& text)
+	{
+		FOREACH(char c, text)
+		{
+			if (c == '"' || c == '\\')
+				stream << '\\';
+
+			stream << c;
+		}
+	}
+}
+
+void Profiler::setThreadName(const std::string& name)
+{
+	// Would allocate a buffer that no zone ever fills
+#ifndef BOOK_ENABLE_PROFILER
+	return;
+#endif
+
+	ThreadBuffer* buffer = getThreadBuffer();
+	if (!buffer)
+		return;
+
+	sf::Lock lock(registryMutex);
+	buffer->name = name;
+}
+
+void Profiler::startCapture()
+{
+	// Writers never reset their buffers; a capture just starts at their current position
+	sf::Lock lock(registryMutex);
+	FOREACH(auto& buffer, registry)
+		buffer->captureBegin = buffer->count.load(std::memory_order_acquire);
+
+	capturing = true;
+}
+
+void Profiler::stopCapture()
+{
+	capturing = false;
+}
+
+bool Profiler::isCapturing()
+{
+	return capturing.load(std::memory_order_relaxed);
+}
+
+bool Profiler::exportChromeTrace(const std::string& filename)
+{
+	std::ofstream file(filename.c_str());
+	if (!file)
+		return false;
+
+	file << "{\"traceEvents\":[\n";
+	bool first = true;
+
+	sf::Lock lock(registryMutex);
+	for (std::size_t tid = 0; tid < registry.size(); ++tid)
+	{
+		ThreadBuffer& buffer = *registry[tid];
+
+		file << (first ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << tid << ",\"args\":{\"name\":\"";
+		writeEscaped(file, buffer.name);
+		file << "\"}}";
+		first = false;
+
+		// Only the newest EventCapacity events are still in the ring
+		std::size_t end = buffer.count.load(std::memory_order_acquire);
+		std::size_t begin = std::max(buffer.captureBegin, end > EventCapacity ? end - EventCapacity : 0);
+
+		// Complete events; the viewer nests them by their time ranges
+		for (std::size_t i = begin; i < end; ++i)
+		{
+			const Event& event = buffer.events[i % EventCapacity];
+
+			file << ",\n{\"name\":\"";
+			writeEscaped(file, event.name);
+			file << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << tid << ",\"ts\":" << event.start << ",\"dur\":" << event.end - event.start << "}";
+		}
+	}
+
+	file << "\n]}\n";
+	return static_cast<bool>(file);
+}
+
+sf::Int64 Profiler::now()
+{
+	return profileClock.getElapsedTime().asMicroseconds();
+}
+
+void Profiler::record(const char* name, sf::Int64 start, sf::Int64 end)
+{
+	ThreadBuffer* buffer = getThreadBuffer();
+	if (!buffer)
+		return;
+
+	std::size_t index = buffer->count.load(std::memory_order_relaxed);
+
+	Event& event = buffer->events[index % EventCapacity];
+	event.name = name;
+	event.start = start;
+	event.end = end;
+
+	// Publishes the event to exportChromeTrace()
+	buffer->count.store(index + 1, std::memory_order_release);
+}
+
+ProfileZone::ProfileZone(const char* name)
+: mName(name)
+, mStart(Profiler::isCapturing() ? Profiler::now() : -1)
+{
+}
+
+ProfileZone::~ProfileZone()
+{
+	if (mStart >= 0 && Profiler::isCapturing())
+		Profiler::record(mName, mStart, Profiler::now());
+}
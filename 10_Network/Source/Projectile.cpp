@@ -71,6 +71,16 @@ void Projectile::drawCurrent(sf::RenderTarget& target, sf::RenderStates states)
 	target.draw(mSprite, states);
 }
 
+void Projectile::collectCurrentStatistics(SceneStatistics& statistics) const
+{
+	++statistics.drawCalls;
+}
+
+Projectile::Type Projectile::getType() const
+{
+	return mType;
+}
+
 unsigned int Projectile::getCategory() const
 {
 	if (mType == EnemyBullet)
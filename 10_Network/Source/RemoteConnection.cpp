@@ -0,0 +1,246 @@
+#include <Book/RemoteConnection.hpp>
+#include <Book/Profiler.hpp>
+
+#include <SFML/System/Sleep.hpp>
+#include <SFML/Network/IpAddress.hpp>
+#include <SFML/Network/SocketSelector.hpp>
+
+#include <algorithm>
+#include <memory>
+#include <thread>
+
+
+namespace
+{
+	const std::size_t IncomingCapacity = 1024;
+	const std::size_t OutgoingCapacity = 256;
+
+	// Upper bound for how long an outgoing packet waits while the thread listens for incoming ones
+	const sf::Time PollInterval = sf::milliseconds(1);
+
+	// A hosted server may not be listening yet when the first attempt is refused
+	const sf::Time ConnectRetryDelay = sf::milliseconds(250);
+	const sf::Time MaxAttemptTime = sf::seconds(1.f);
+
+	// sf::TcpSocket prefixes every packet with its 32-bit size
+	const std::size_t PacketHeaderSize = 4;
+
+	// Result of a DNS lookup, shared by the lookup thread and whoever waits for it
+	struct Resolution
+	{
+		Resolution()
+		: address()
+		, done(false)
+		{
+		}
+
+		sf::IpAddress			address;
+		std::atomic<bool>		done;
+	};
+}
+
+RemoteConnection::RemoteConnection(const std::string& serverName, unsigned short port, sf::Time timeout)
+: mServerName(serverName)
+, mPort(port)
+, mTimeout(timeout)
+, mClock()
+, mSocket()
+, mIncoming(IncomingCapacity)
+, mOutgoing(OutgoingCapacity)
+, mDroppedPackets(0)
+, mBytesReceived(0)
+, mBytesSent(0)
+, mStatus(Resolving)
+, mStopRequested(false)
+, mResolveTime()
+, mConnectTime()
+, mConnectAttempts(0)
+, mThread(&RemoteConnection::networkThread, this)
+{
+	mThread.launch();
+}
+
+RemoteConnection::~RemoteConnection()
+{
+	// The thread flushes packets sent before this point, e.g. a quit notification
+	mStopRequested = true;
+	mThread.wait();
+}
+
+ServerConnection::Status RemoteConnection::getStatus() const
+{
+	return static_cast<Status>(mStatus.load());
+}
+
+sf::Time RemoteConnection::now() const
+{
+	return mClock.getElapsedTime();
+}
+
+sf::Time RemoteConnection::getResolveTime() const
+{
+	return mResolveTime;
+}
+
+sf::Time RemoteConnection::getConnectTime() const
+{
+	return mConnectTime;
+}
+
+std::size_t RemoteConnection::getConnectAttempts() const
+{
+	return mConnectAttempts;
+}
+
+bool RemoteConnection::send(const sf::Packet& packet)
+{
+	if (mOutgoing.push(packet))
+		return true;
+
+	++mDroppedPackets;
+	return false;
+}
+
+bool RemoteConnection::pollMessage(Message& message)
+{
+	return mIncoming.pop(message);
+}
+
+std::size_t RemoteConnection::getPendingMessageCount() const
+{
+	return mIncoming.size();
+}
+
+std::size_t RemoteConnection::getBytesReceived() const
+{
+	return mBytesReceived;
+}
+
+std::size_t RemoteConnection::getBytesSent() const
+{
+	return mBytesSent;
+}
+
+std::size_t RemoteConnection::getDroppedPacketCount() const
+{
+	return mDroppedPackets;
+}
+
+void RemoteConnection::networkThread()
+{
+	Profiler::setThreadName("Network");
+
+	if (!connectToServer())
+	{
+		mStatus = Disconnected;
+		return;
+	}
+
+	mStatus = Connected;
+
+	// The socket stays blocking, so a packet is always sent or received as a whole
+	sf::SocketSelector selector;
+	selector.add(mSocket);
+
+	bool connected = true;
+	while (connected && !mStopRequested)
+	{
+		if (selector.wait(PollInterval))
+			connected = receiveMessage();
+
+		if (connected)
+			connected = sendPackets();
+	}
+
+	// Deliver what was sent until the destructor was called
+	if (connected)
+		sendPackets();
+
+	mSocket.disconnect();
+	mStatus = Disconnected;
+}
+
+bool RemoteConnection::connectToServer()
+{
+	// A DNS lookup can't be interrupted. It runs on a detached thread owning its result (sf::Thread can't be
+	// detached), so a cancelled connection returns right away and leaves the lookup to finish on its own.
+	std::shared_ptr<Resolution> resolution = std::make_shared<Resolution>();
+	std::string serverName = mServerName;
+	std::thread([resolution, serverName] ()
+	{
+		resolution->address = sf::IpAddress(serverName);
+		resolution->done = true;
+	}).detach();
+
+	while (!resolution->done)
+	{
+		if (mStopRequested)
+			return false;
+
+		sf::sleep(PollInterval);
+	}
+
+	sf::IpAddress address = resolution->address;
+	if (address == sf::IpAddress::None)
+		return false;
+
+	mResolveTime = now();
+
+	// Short attempts, so a cancelled connection does not keep the thread busy for long
+	mStatus = Connecting;
+	while (!mStopRequested && now() < mResolveTime + mTimeout)
+	{
+		++mConnectAttempts;
+
+		sf::Time attemptTime = std::min(MaxAttemptTime, mResolveTime + mTimeout - now());
+		if (mSocket.connect(address, mPort, attemptTime) == sf::Socket::Done)
+		{
+			mConnectTime = now() - mResolveTime;
+			return true;
+		}
+
+		sf::sleep(ConnectRetryDelay);
+	}
+
+	return false;
+}
+
+bool RemoteConnection::receiveMessage()
+{
+	Message message;
+	sf::Socket::Status status = mSocket.receive(message.packet);
+	if (status != sf::Socket::Done)
+		return status == sf::Socket::NotReady;
+
+	mBytesReceived += PacketHeaderSize + message.packet.getDataSize();
+
+	// Stamped on arrival, so time spent waiting in the queue shows up in latency measurements
+	message.arrivalTime = now();
+	message.packet >> message.type;
+
+	// A full queue means the game thread is behind; wait rather than lose state updates
+	while (!mIncoming.push(message))
+	{
+		if (mStopRequested)
+			return true;
+
+		sf::sleep(PollInterval);
+	}
+
+	return true;
+}
+
+bool RemoteConnection::sendPackets()
+{
+	sf::Packet packet;
+	while (mOutgoing.pop(packet))
+	{
+		sf::Socket::Status status = mSocket.send(packet);
+		if (status == sf::Socket::Disconnected || status == sf::Socket::Error)
+			return false;
+
+		mBytesSent += PacketHeaderSize + packet.getDataSize();
+	}
+
+	return true;
+}
@@ -0,0 +1,90 @@
+#include <Book/RenderTargetPool.hpp>
+#include <Book/Foreach.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+#include <cassert>
+
+
+namespace
+{
+	// Free targets survive this many collectUnused() calls without being acquired
+	const unsigned int MaxIdleFrames = 120;
+}
+
+RenderTargetPool::RenderTargetPool()
+: mEntries()
+{
+}
+
+sf::RenderTexture& RenderTargetPool::acquire(sf::Vector2u size, bool smooth, bool depthBuffer)
+{
+	// Zero-sized textures cannot be created
+	size.x = std::max(size.x, 1u);
+	size.y = std::max(size.y, 1u);
+
+	// Reuse a free target with matching size and format
+	FOREACH(EntryPtr& entry, mEntries)
+	{
+		if (!entry->inUse && entry->size == size && entry->depthBuffer == depthBuffer)
+		{
+			entry->inUse = true;
+			entry->idleFrames = 0;
+			entry->texture.setSmooth(smooth);
+			return entry->texture;
+		}
+	}
+
+	// None available: create a new one
+	EntryPtr entry(new Entry());
+	if (!entry->texture.create(size.x, size.y, depthBuffer))
+		throw std::runtime_error("RenderTargetPool::acquire - Failed to create render texture");
+
+	entry->texture.setSmooth(smooth);
+	entry->size = size;
+	entry->depthBuffer = depthBuffer;
+	entry->inUse = true;
+	entry->idleFrames = 0;
+
+	mEntries.push_back(std::move(entry));
+	return mEntries.back()->texture;
+}
+
+void RenderTargetPool::release(const sf::RenderTexture& target)
+{
+	auto found = std::find_if(mEntries.begin(), mEntries.end(), [&] (EntryPtr& entry) { return &entry->texture == &target; });
+	assert(found != mEntries.end() && (*found)->inUse);
+
+	(*found)->inUse = false;
+}
+
+void RenderTargetPool::collectUnused()
+{
+	FOREACH(EntryPtr& entry, mEntries)
+	{
+		if (!entry->inUse)
+			++entry->idleFrames;
+	}
+
+	// Destroy targets that stayed free for too long, e.g. after the output size changed
+	auto firstToRemove = std::remove_if(mEntries.begin(), mEntries.end(), [] (EntryPtr& entry)
+	{
+		return !entry->inUse && entry->idleFrames > MaxIdleFrames;
+	});
+	mEntries.erase(firstToRemove, mEntries.end());
+}
+
+std::size_t RenderTargetPool::getTargetCount() const
+{
+	return mEntries.size();
+}
+
+std::size_t RenderTargetPool::getMemoryUsage() const
+{
+	// Approximation: 4 bytes per pixel
+	std::size_t bytes = 0;
+	FOREACH(const EntryPtr& entry, mEntries)
+		bytes += 4 * entry->size.x * entry->size.y;
+
+	return bytes;
+}
@@ -0,0 +1,115 @@
+#include <Book/ResolutionScaler.hpp>
+#include <Book/Foreach.hpp>
+
+#include <algorithm>
+#include <cassert>
+
+
+namespace
+{
+	// Scale changes per evaluation; lowering is faster than raising to recover quickly from overload
+	const float LowerStep = 0.1f;
+	const float RaiseStep = 0.05f;
+
+	// Frame time thresholds relative to the target
+	const float LowerThreshold = 1.15f;
+	const float RaiseThreshold = 1.05f;
+
+	// Consecutive periods within the budget before the scale is raised again (hysteresis)
+	const std::size_t StablePeriodsBeforeRaise = 4;
+
+	// Frames longer than this are hitches (loading, window dragging) rather than render load
+	const sf::Time MaxSampleTime = sf::seconds(0.25f);
+}
+
+ResolutionScaler::ResolutionScaler(float minScale, sf::Time targetFrameTime)
+: mMinScale(minScale)
+, mScale(1.f)
+, mTargetFrameTime(targetFrameTime)
+, mSamples()
+, mSampleIndex(0)
+, mAverageFrameTime(sf::Time::Zero)
+, mStablePeriods(0)
+, mLastDecision(Kept)
+{
+	assert(minScale > 0.f && minScale <= 1.f);
+}
+
+void ResolutionScaler::addFrame(sf::Time frameTime)
+{
+	if (frameTime > MaxSampleTime)
+		return;
+
+	mSamples[mSampleIndex++] = frameTime;
+
+	// Decide once per full window of samples
+	if (mSampleIndex == SampleCount)
+	{
+		evaluate();
+		mSampleIndex = 0;
+	}
+}
+
+void ResolutionScaler::setMinScale(float minScale)
+{
+	assert(minScale > 0.f && minScale <= 1.f);
+
+	mMinScale = minScale;
+	mScale = std::max(mScale, mMinScale);
+}
+
+float ResolutionScaler::getScale() const
+{
+	return mScale;
+}
+
+sf::Vector2u ResolutionScaler::getScaledSize(sf::Vector2u size) const
+{
+	return sf::Vector2u(
+		std::max(1u, static_cast<unsigned int>(size.x * mScale + 0.5f)),
+		std::max(1u, static_cast<unsigned int>(size.y * mScale + 0.5f)));
+}
+
+ResolutionScaler::Decision ResolutionScaler::getLastDecision() const
+{
+	return mLastDecision;
+}
+
+sf::Time ResolutionScaler::getAverageFrameTime() const
+{
+	return mAverageFrameTime;
+}
+
+void ResolutionScaler::evaluate()
+{
+	sf::Time total = sf::Time::Zero;
+	FOREACH(sf::Time sample, mSamples)
+		total += sample;
+
+	mAverageFrameTime = total / static_cast<float>(SampleCount);
+	mLastDecision = Kept;
+
+	if (mAverageFrameTime > mTargetFrameTime * LowerThreshold)
+	{
+		mStablePeriods = 0;
+
+		if (mScale > mMinScale)
+		{
+			mScale = std::max(mMinScale, mScale - LowerStep);
+			mLastDecision = Lowered;
+		}
+	}
+	else if (mAverageFrameTime < mTargetFrameTime * RaiseThreshold)
+	{
+		if (++mStablePeriods >= StablePeriodsBeforeRaise && mScale < 1.f)
+		{
+			mScale = std::min(1.f, mScale + RaiseStep);
+			mStablePeriods = 0;
+			mLastDecision = Raised;
+		}
+	}
+	else
+	{
+		mStablePeriods = 0;
+	}
+}
@@ -0,0 +1,89 @@
+#include <Book/ResourceDecoder.hpp>
+
+#include <fstream>
+#include <iterator>
+
+
+ResourceDecoder<sf::Texture>::ResourceDecoder(const AssetArchive* archive)
+: mArchive(archive)
+, mImage()
+, mArea()
+{
+}
+
+bool ResourceDecoder<sf::Texture>::decode(const std::string& filename)
+{
+	return decode(filename, sf::IntRect());
+}
+
+bool ResourceDecoder<sf::Texture>::decode(const std::string& filename, const sf::IntRect& area)
+{
+	mArea = area;
+
+	const AssetArchive::Entry* entry = mArchive ? mArchive->find(filename) : nullptr;
+	if (entry)
+		return mImage.loadFromMemory(entry->data, entry->size);
+
+	return mImage.loadFromFile(filename);
+}
+
+std::unique_ptr<sf::Texture> ResourceDecoder<sf::Texture>::finalize()
+{
+	std::unique_ptr<sf::Texture> texture(new sf::Texture());
+	if (!texture->loadFromImage(mImage, mArea))
+		return nullptr;
+
+	return texture;
+}
+
+ResourceDecoder<sf::Shader>::ResourceDecoder(const AssetArchive* archive)
+: mArchive(archive)
+, mVertexSource()
+, mFragmentSource()
+{
+}
+
+bool ResourceDecoder<sf::Shader>::decode(const std::string& filename, sf::Shader::Type type)
+{
+	return readSource(filename, type == sf::Shader::Vertex ? mVertexSource : mFragmentSource);
+}
+
+bool ResourceDecoder<sf::Shader>::decode(const std::string& vertexShaderFilename, const std::string& fragmentShaderFilename)
+{
+	return readSource(vertexShaderFilename, mVertexSource) && readSource(fragmentShaderFilename, mFragmentSource);
+}
+
+std::unique_ptr<sf::Shader> ResourceDecoder<sf::Shader>::finalize()
+{
+	std::unique_ptr<sf::Shader> shader(new sf::Shader());
+
+	bool loaded;
+	if (mVertexSource.empty())
+		loaded = shader->loadFromMemory(mFragmentSource, sf::Shader::Fragment);
+	else if (mFragmentSource.empty())
+		loaded = shader->loadFromMemory(mVertexSource, sf::Shader::Vertex);
+	else
+		loaded = shader->loadFromMemory(mVertexSource, mFragmentSource);
+
+	if (!loaded)
+		return nullptr;
+
+	return shader;
+}
+
+bool ResourceDecoder<sf::Shader>::readSource(const std::string& filename, std::string& source)
+{
+	const AssetArchive::Entry* entry = mArchive ? mArchive->find(filename) : nullptr;
+	if (entry)
+	{
+		source.assign(static_cast<const char*>(entry->data), entry->size);
+		return true;
+	}
+
+	std::ifstream file(filename.c_str(), std::ios::in | std::ios::binary);
+	if (!file)
+		return false;
+
+	source.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	return true;
+}
@@ -0,0 +1,17 @@
+#include <Book/ResourceHolder.hpp>
+
+#include <SFML/Graphics/Texture.hpp>
+#include <SFML/Audio/SoundBuffer.hpp>
+
+
+std::size_t estimateMemoryUsage(const sf::Texture& texture)
+{
+	// RGBA texels, without driver overhead or mipmaps
+	sf::Vector2u size = texture.getSize();
+	return 4 * size.x * size.y;
+}
+
+std::size_t estimateMemoryUsage(const sf::SoundBuffer& soundBuffer)
+{
+	return soundBuffer.getSampleCount() * sizeof(sf::Int16);
+}
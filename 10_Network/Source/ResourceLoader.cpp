@@ -0,0 +1,152 @@
+#include <Book/ResourceLoader.hpp>
+
+#include <SFML/System/Clock.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+
+
+ResourceLoader::Handle::Handle()
+: mReady(std::make_shared<bool>(false))
+{
+}
+
+bool ResourceLoader::Handle::isReady() const
+{
+	return *mReady;
+}
+
+ResourceLoader::ResourceLoader(std::size_t threadCount)
+: mThreadCount(threadCount)
+, mWorkers()
+, mMutex()
+, mJobCondition()
+, mStopRequested(false)
+, mPendingJobs()
+, mDecodedJobs()
+, mQueuedCount(0)
+, mFinishedCount(0)
+{
+	// Decoding is mostly disk and inflate bound; a few threads are enough
+	if (mThreadCount == 0)
+		mThreadCount = std::max(1u, std::min(4u, std::thread::hardware_concurrency()));
+
+	for (std::size_t i = 0; i < mThreadCount; ++i)
+	{
+		mWorkers.push_back(std::unique_ptr<sf::Thread>(new sf::Thread(&ResourceLoader::workerThread, this)));
+		mWorkers.back()->launch();
+	}
+}
+
+ResourceLoader::~ResourceLoader()
+{
+	// Jobs in progress are finished, sf::Thread's destructor waits for them
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mPendingJobs.clear();
+		mStopRequested = true;
+	}
+
+	mJobCondition.notify_all();
+	mWorkers.clear();
+}
+
+ResourceLoader::Handle ResourceLoader::enqueue(const std::string& filename, Step decode, Step finalize)
+{
+	Handle handle;
+
+	Job job;
+	job.filename = filename;
+	job.decode = std::move(decode);
+	job.finalize = std::move(finalize);
+	job.decoded = false;
+	job.ready = handle.mReady;
+
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mPendingJobs.push_back(std::move(job));
+	}
+
+	mJobCondition.notify_one();
+
+	++mQueuedCount;
+	return handle;
+}
+
+void ResourceLoader::update(sf::Time budget)
+{
+	sf::Clock clock;
+
+	// Finalize at least one job per call, then as many as fit into the budget
+	do
+	{
+		Job job;
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			if (mDecodedJobs.empty())
+				break;
+
+			job = std::move(mDecodedJobs.front());
+			mDecodedJobs.pop_front();
+		}
+
+		if (!job.decoded || !job.finalize())
+			throw std::runtime_error("ResourceLoader::update - Failed to load " + job.filename);
+
+		*job.ready = true;
+		++mFinishedCount;
+	}
+	while (clock.getElapsedTime() < budget);
+
+	// Restart progress for the next batch
+	if (isFinished())
+	{
+		mQueuedCount = 0;
+		mFinishedCount = 0;
+	}
+}
+
+bool ResourceLoader::isFinished() const
+{
+	return mFinishedCount == mQueuedCount;
+}
+
+float ResourceLoader::getCompletion() const
+{
+	if (mQueuedCount == 0)
+		return 1.f;
+
+	return static_cast<float>(mFinishedCount) / mQueuedCount;
+}
+
+void ResourceLoader::workerThread()
+{
+	for (;;)
+	{
+		Job job;
+		{
+			std::unique_lock<std::mutex> lock(mMutex);
+			mJobCondition.wait(lock, [this] () { return mStopRequested || !mPendingJobs.empty(); });
+
+			if (mStopRequested)
+				return;
+
+			job = std::move(mPendingJobs.front());
+			mPendingJobs.pop_front();
+		}
+
+		// Errors are reported on the owning thread, where update() throws
+		try
+		{
+			job.decoded = job.decode();
+		}
+		catch (std::exception&)
+		{
+			job.decoded = false;
+		}
+
+		std::lock_guard<std::mutex> lock(mMutex);
+		mDecodedJobs.push_back(std::move(job));
+	}
+}
@@ -11,10 +11,22 @@
 #include <cmath>
 
 
+SceneStatistics::SceneStatistics()
+: nodes(0)
+, drawCalls(0)
+, particles(0)
+, categories()
+{
+}
+
 SceneNode::SceneNode(Category::Type category)
 : mChildren()
 , mParent(nullptr)
 , mDefaultCategory(category)
+, mPreviousPosition()
+, mPreviousRotation(0.f)
+, mHasPreviousState(false)
+, mRenderTransform()
 {
 }
 
@@ -37,10 +49,44 @@ SceneNode::Ptr SceneNode::detachChild(const SceneNode& node)
 
 void SceneNode::update(sf::Time dt, CommandQueue& commands)
 {
+	// Remember the last simulated state, rendering interpolates from it towards the new one
+	mPreviousPosition = getPosition();
+	mPreviousRotation = getRotation();
+	mHasPreviousState = true;
+
 	updateCurrent(dt, commands);
 	updateChildren(dt, commands);
 }
 
+void SceneNode::interpolate(float alpha)
+{
+	// Nodes that have not been simulated yet are rendered at their current state
+	if (mHasPreviousState)
+	{
+		// Rotate along the shorter arc
+		float rotationDelta = getRotation() - mPreviousRotation;
+		if (rotationDelta > 180.f)
+			rotationDelta -= 360.f;
+		else if (rotationDelta < -180.f)
+			rotationDelta += 360.f;
+
+		sf::Transformable state;
+		state.setOrigin(getOrigin());
+		state.setScale(getScale());
+		state.setPosition(mPreviousPosition + (getPosition() - mPreviousPosition) * alpha);
+		state.setRotation(mPreviousRotation + rotationDelta * alpha);
+
+		mRenderTransform = state.getTransform();
+	}
+	else
+	{
+		mRenderTransform = getTransform();
+	}
+
+	FOREACH(Ptr& child, mChildren)
+		child->interpolate(alpha);
+}
+
 void SceneNode::updateCurrent(sf::Time, CommandQueue&)
 {
 	// Do nothing by default
@@ -54,8 +100,8 @@ void SceneNode::updateChildren(sf::Time dt, CommandQueue& commands)
 
 void SceneNode::draw(sf::RenderTarget& target, sf::RenderStates states) const
 {
-	// Apply transform of current node
-	states.transform *= getTransform();
+	// Apply interpolated transform of current node
+	states.transform *= mRenderTransform;
 
 	// Draw node and children with changed transform
 	drawCurrent(target, states);
@@ -121,21 +167,22 @@ unsigned int SceneNode::getCategory() const
 	return mDefaultCategory;
 }
 
-void SceneNode::checkSceneCollision(SceneNode& sceneGraph, std::set<Pair>& collisionPairs)
+void SceneNode::checkSceneCollision(SceneNode& sceneGraph, std::set<Pair>& collisionPairs, std::size_t& testCount)
 {
-	checkNodeCollision(sceneGraph, collisionPairs);
+	checkNodeCollision(sceneGraph, collisionPairs, testCount);
 
 	FOREACH(Ptr& child, sceneGraph.mChildren)
-		checkSceneCollision(*child, collisionPairs);
+		checkSceneCollision(*child, collisionPairs, testCount);
 }
 
-void SceneNode::checkNodeCollision(SceneNode& node, std::set<Pair>& collisionPairs)
+void SceneNode::checkNodeCollision(SceneNode& node, std::set<Pair>& collisionPairs, std::size_t& testCount)
 {
+	++testCount;
 	if (this != &node && collision(*this, node) && !isDestroyed() && !node.isDestroyed())
 		collisionPairs.insert(std::minmax(this, &node));
 
 	FOREACH(Ptr& child, mChildren)
-		child->checkNodeCollision(node, collisionPairs);
+		child->checkNodeCollision(node, collisionPairs, testCount);
 }
 
 void SceneNode::removeWrecks()
@@ -148,6 +195,34 @@ void SceneNode::removeWrecks()
 	std::for_each(mChildren.begin(), mChildren.end(), std::mem_fn(&SceneNode::removeWrecks));
 }
 
+void SceneNode::collectStatistics(SceneStatistics& statistics) const
+{
+	++statistics.nodes;
+	++statistics.categories[getCategory()];
+	collectCurrentStatistics(statistics);
+
+	FOREACH(const Ptr& child, mChildren)
+		child->collectStatistics(statistics);
+}
+
+void SceneNode::rebase(sf::Vector2f offset)
+{
+	// Keep the interpolation from jumping across the offset
+	move(offset);
+	mPreviousPosition += offset;
+}
+
+void SceneNode::rebaseChildren(sf::Vector2f offset)
+{
+	FOREACH(Ptr& child, mChildren)
+		child->rebase(offset);
+}
+
+void SceneNode::collectCurrentStatistics(SceneStatistics&) const
+{
+	// Nothing drawn by default
+}
+
 sf::FloatRect SceneNode::getBoundingRect() const
 {
 	return sf::FloatRect();
@@ -0,0 +1,6 @@
+#include <Book/ServerConnection.hpp>
+
+
+ServerConnection::~ServerConnection()
+{
+}
@@ -0,0 +1,429 @@
+#include <Book/SoftwareBloomEffect.hpp>
+#include <Book/Profiler.hpp>
+
+#include <SFML/Graphics/Image.hpp>
+#include <SFML/Graphics/RenderTexture.hpp>
+#include <SFML/Graphics/VertexArray.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define BOOK_BLOOM_SSE2
+	#include <emmintrin.h>
+#endif
+
+
+namespace
+{
+	// Constants of Brightness.frag and GuassianBlur.frag
+	const float Threshold = 0.7f;
+	const float Factor = 4.f;
+	const float BlurWeights[5] = { 0.2270270270f, 0.1945945946f, 0.1216216216f, 0.0540540541f, 0.0162162162f };
+
+	// Bands smaller than this are not worth waking a worker
+	const unsigned int MinRowsPerThread = 32;
+
+
+	// One RGBA pixel. With SSE2, all four channels are processed in one register.
+#ifdef BOOK_BLOOM_SSE2
+	typedef __m128 Pixel;
+
+	inline Pixel loadPixel(const float* p)			{ return _mm_loadu_ps(p); }
+	inline void storePixel(float* p, Pixel v)		{ _mm_storeu_ps(p, v); }
+	inline Pixel zeroPixel()						{ return _mm_setzero_ps(); }
+	inline Pixel addPixels(Pixel a, Pixel b)		{ return _mm_add_ps(a, b); }
+	inline Pixel scalePixel(Pixel a, float factor)	{ return _mm_mul_ps(a, _mm_set1_ps(factor)); }
+	inline Pixel saturate(Pixel a)					{ return _mm_min_ps(_mm_max_ps(a, _mm_setzero_ps()), _mm_set1_ps(1.f)); }
+
+	inline Pixel loadPixel(const sf::Uint8* p)
+	{
+		__m128i bytes = _mm_cvtsi32_si128(*reinterpret_cast<const int*>(p));
+		__m128i words = _mm_unpacklo_epi8(bytes, _mm_setzero_si128());
+		__m128i ints = _mm_unpacklo_epi16(words, _mm_setzero_si128());
+		return _mm_mul_ps(_mm_cvtepi32_ps(ints), _mm_set1_ps(1.f / 255.f));
+	}
+
+	inline void storePixel(sf::Uint8* p, Pixel v)
+	{
+		__m128i ints = _mm_cvtps_epi32(_mm_mul_ps(saturate(v), _mm_set1_ps(255.f)));
+		__m128i words = _mm_packs_epi32(ints, ints);
+		__m128i bytes = _mm_packus_epi16(words, words);
+		*reinterpret_cast<int*>(p) = _mm_cvtsi128_si32(bytes);
+	}
+#else
+	struct Pixel
+	{
+		float c[4];
+	};
+
+	inline Pixel loadPixel(const float* p)
+	{
+		Pixel result = {{ p[0], p[1], p[2], p[3] }};
+		return result;
+	}
+
+	inline void storePixel(float* p, Pixel v)
+	{
+		std::copy(v.c, v.c + 4, p);
+	}
+
+	inline Pixel zeroPixel()
+	{
+		Pixel result = {{ 0.f, 0.f, 0.f, 0.f }};
+		return result;
+	}
+
+	inline Pixel addPixels(Pixel a, Pixel b)
+	{
+		for (int i = 0; i < 4; ++i)
+			a.c[i] += b.c[i];
+		return a;
+	}
+
+	inline Pixel scalePixel(Pixel a, float factor)
+	{
+		for (int i = 0; i < 4; ++i)
+			a.c[i] *= factor;
+		return a;
+	}
+
+	inline Pixel saturate(Pixel a)
+	{
+		for (int i = 0; i < 4; ++i)
+			a.c[i] = std::min(std::max(a.c[i], 0.f), 1.f);
+		return a;
+	}
+
+	inline Pixel loadPixel(const sf::Uint8* p)
+	{
+		Pixel result = {{ p[0] / 255.f, p[1] / 255.f, p[2] / 255.f, p[3] / 255.f }};
+		return result;
+	}
+
+	inline void storePixel(sf::Uint8* p, Pixel v)
+	{
+		v = saturate(v);
+		for (int i = 0; i < 4; ++i)
+			p[i] = static_cast<sf::Uint8>(v.c[i] * 255.f + 0.5f);
+	}
+#endif
+
+	inline int clampIndex(int index, unsigned int size)
+	{
+		return std::min(std::max(index, 0), static_cast<int>(size) - 1);
+	}
+
+	inline const float* pixelAt(const SoftwareBloomEffect::Buffer& buffer, int x, int y)
+	{
+		return &buffer.pixels[4 * (clampIndex(y, buffer.height) * buffer.width + clampIndex(x, buffer.width))];
+	}
+
+	// Source pixels and weight of a bilinear lookup along one axis, with clamp-to-edge addressing
+	struct SampleTap
+	{
+		int		first;
+		int		second;
+		float	weight;
+	};
+
+	// Maps each of the outputSize pixel centers into a source of inputSize pixels, as done by a smooth texture
+	std::vector<SampleTap> computeSampleTaps(unsigned int outputSize, unsigned int inputSize)
+	{
+		std::vector<SampleTap> taps(outputSize);
+		float scale = static_cast<float>(inputSize) / outputSize;
+
+		for (unsigned int i = 0; i < outputSize; ++i)
+		{
+			float position = (i + 0.5f) * scale - 0.5f;
+			int index = static_cast<int>(std::floor(position));
+
+			taps[i].first = clampIndex(index, inputSize);
+			taps[i].second = clampIndex(index + 1, inputSize);
+			taps[i].weight = position - index;
+		}
+
+		return taps;
+	}
+
+	Pixel sampleBilinear(const SoftwareBloomEffect::Buffer& buffer, const SampleTap& column, const SampleTap& row)
+	{
+		const float* top = &buffer.pixels[4 * row.first * buffer.width];
+		const float* bottom = &buffer.pixels[4 * row.second * buffer.width];
+
+		Pixel upper = addPixels(scalePixel(loadPixel(top + 4 * column.first), 1.f - column.weight), scalePixel(loadPixel(top + 4 * column.second), column.weight));
+		Pixel lower = addPixels(scalePixel(loadPixel(bottom + 4 * column.first), 1.f - column.weight), scalePixel(loadPixel(bottom + 4 * column.second), column.weight));
+		return addPixels(scalePixel(upper, 1.f - row.weight), scalePixel(lower, row.weight));
+	}
+
+	// Draws the whole texture over the whole target
+	void drawStretched(const sf::Texture& texture, sf::RenderTarget& output, sf::BlendMode blendMode)
+	{
+		sf::Vector2f outputSize = static_cast<sf::Vector2f>(output.getSize());
+		sf::Vector2f textureSize = static_cast<sf::Vector2f>(texture.getSize());
+
+		sf::VertexArray vertices(sf::TrianglesStrip, 4);
+		vertices[0] = sf::Vertex(sf::Vector2f(0, 0),            sf::Vector2f(0, 0));
+		vertices[1] = sf::Vertex(sf::Vector2f(outputSize.x, 0), sf::Vector2f(textureSize.x, 0));
+		vertices[2] = sf::Vertex(sf::Vector2f(0, outputSize.y), sf::Vector2f(0, textureSize.y));
+		vertices[3] = sf::Vertex(sf::Vector2f(outputSize),      sf::Vector2f(textureSize));
+
+		sf::RenderStates states;
+		states.texture   = &texture;
+		states.blendMode = blendMode;
+
+		output.draw(vertices, states);
+	}
+}
+
+
+SoftwareBloomEffect::Buffer::Buffer()
+: pixels()
+, width(0)
+, height(0)
+{
+}
+
+void SoftwareBloomEffect::Buffer::resize(unsigned int width, unsigned int height)
+{
+	this->width = std::max(width, 1u);
+	this->height = std::max(height, 1u);
+	pixels.resize(4 * this->width * this->height);
+}
+
+SoftwareBloomEffect::SoftwareBloomEffect(std::size_t threadCount)
+: mWorkers(threadCount)
+, mSize()
+, mBrightness()
+, mFirstPass()
+, mSecondPass()
+, mResult()
+, mOutputTexture()
+{
+}
+
+void SoftwareBloomEffect::apply(const sf::RenderTexture& input, sf::RenderTarget& output)
+{
+	// The passes need the scene on the CPU, but the final addition is left to the GPU:
+	// only the half size bloom is uploaded, and blended additively over the unchanged input.
+	sf::Image image = input.getTexture().copyToImage();
+	process(image.getPixelsPtr(), image.getSize());
+
+	const Buffer& bloom = mFirstPass[1];
+	convertBloom(bloom);
+
+	// Smooth filtering upscales the bloom, like the texture lookups of Add.frag
+	if (mOutputTexture.getSize() != sf::Vector2u(bloom.width, bloom.height))
+	{
+		mOutputTexture.create(bloom.width, bloom.height);
+		mOutputTexture.setSmooth(true);
+	}
+	mOutputTexture.update(&mResult[0]);
+
+	drawStretched(input.getTexture(), output, sf::BlendNone);
+	drawStretched(mOutputTexture, output, sf::BlendAdd);
+}
+
+void SoftwareBloomEffect::apply(const sf::Image& input, sf::Image& output)
+{
+	process(input.getPixelsPtr(), input.getSize());
+	addFinal(input.getPixelsPtr(), mFirstPass[1]);
+	output.create(mSize.x, mSize.y, &mResult[0]);
+}
+
+void SoftwareBloomEffect::process(const sf::Uint8* input, sf::Vector2u size)
+{
+	BOOK_PROFILE_ZONE("SoftwareBloomEffect::process");
+
+	// Same pass sequence as BloomEffect::apply()
+	prepareBuffers(size);
+
+	filterBright(input);
+
+	downsample(mBrightness, mFirstPass[0]);
+	blurMultipass(mFirstPass[0], mFirstPass[1]);
+
+	downsample(mFirstPass[0], mSecondPass[0]);
+	blurMultipass(mSecondPass[0], mSecondPass[1]);
+
+	add(mFirstPass[0], mSecondPass[0], mFirstPass[1]);
+}
+
+void SoftwareBloomEffect::prepareBuffers(sf::Vector2u size)
+{
+	if (mSize != size)
+	{
+		mSize = size;
+
+		mBrightness.resize(size.x, size.y);
+		mFirstPass[0].resize(size.x / 2, size.y / 2);
+		mFirstPass[1].resize(size.x / 2, size.y / 2);
+		mSecondPass[0].resize(size.x / 4, size.y / 4);
+		mSecondPass[1].resize(size.x / 4, size.y / 4);
+	}
+}
+
+void SoftwareBloomEffect::filterBright(const sf::Uint8* input)
+{
+	BOOK_PROFILE_ZONE("SoftwareBloomEffect::filterBright");
+
+	Buffer& output = mBrightness;
+
+	mWorkers.run(output.height, MinRowsPerThread, [&] (unsigned int begin, unsigned int end)
+	{
+		for (std::size_t i = 4 * begin * output.width; i < 4 * end * output.width; i += 4)
+		{
+			float luminance = (input[i] * 0.2126f + input[i + 1] * 0.7152f + input[i + 2] * 0.0722f) / 255.f;
+			float factor = std::min(std::max(luminance - Threshold, 0.f), 1.f) * Factor;
+
+			storePixel(&output.pixels[i], saturate(scalePixel(loadPixel(input + i), factor)));
+		}
+	});
+}
+
+void SoftwareBloomEffect::blurMultipass(Buffer& first, Buffer& second)
+{
+	BOOK_PROFILE_ZONE("SoftwareBloomEffect::blurMultipass");
+
+	for (std::size_t count = 0; count < 2; ++count)
+	{
+		blur(first, second, 0, 1);
+		blur(second, first, 1, 0);
+	}
+}
+
+void SoftwareBloomEffect::blur(const Buffer& input, Buffer& output, int dx, int dy)
+{
+	const int width = static_cast<int>(output.width);
+	const int height = static_cast<int>(output.height);
+	const std::ptrdiff_t step = 4 * (dx + dy * width);
+
+	mWorkers.run(output.height, MinRowsPerThread, [&] (unsigned int begin, unsigned int end)
+	{
+		for (int y = static_cast<int>(begin); y < static_cast<int>(end); ++y)
+		{
+			for (int x = 0; x < width; ++x)
+			{
+				const float* center = &input.pixels[4 * (y * width + x)];
+				bool interior = (dx == 0 || (x >= 4 && x < width - 4)) && (dy == 0 || (y >= 4 && y < height - 4));
+
+				// Separable 9-tap Gaussian, symmetric around the center. Taps beyond the border are clamped.
+				Pixel color = scalePixel(loadPixel(center), BlurWeights[0]);
+				for (int tap = 1; tap < 5; ++tap)
+				{
+					Pixel pair = interior
+						? addPixels(loadPixel(center - tap * step), loadPixel(center + tap * step))
+						: addPixels(loadPixel(pixelAt(input, x - tap * dx, y - tap * dy)), loadPixel(pixelAt(input, x + tap * dx, y + tap * dy)));
+
+					color = addPixels(color, scalePixel(pair, BlurWeights[tap]));
+				}
+
+				storePixel(&output.pixels[4 * (y * width + x)], saturate(color));
+			}
+		}
+	});
+}
+
+void SoftwareBloomEffect::downsample(const Buffer& input, Buffer& output)
+{
+	BOOK_PROFILE_ZONE("SoftwareBloomEffect::downsample");
+
+	// DownSample.frag takes 9 bilinear taps around the corner shared by 4 source pixels.
+	// This amounts to a separable [1 2 2 1] / 6 filter on the source pixels.
+	const float weights[4] = { 1.f / 6.f, 2.f / 6.f, 2.f / 6.f, 1.f / 6.f };
+
+	const int inputWidth = static_cast<int>(input.width);
+	const int inputHeight = static_cast<int>(input.height);
+
+	mWorkers.run(output.height, MinRowsPerThread, [&] (unsigned int begin, unsigned int end)
+	{
+		for (int y = static_cast<int>(begin); y < static_cast<int>(end); ++y)
+		{
+			for (int x = 0; x < static_cast<int>(output.width); ++x)
+			{
+				bool interior = x > 0 && 2 * x + 2 < inputWidth && y > 0 && 2 * y + 2 < inputHeight;
+
+				Pixel color = zeroPixel();
+				for (int j = 0; j < 4; ++j)
+				{
+					Pixel row = zeroPixel();
+					for (int i = 0; i < 4; ++i)
+					{
+						int sourceX = 2 * x - 1 + i;
+						int sourceY = 2 * y - 1 + j;
+
+						const float* sample = interior ? &input.pixels[4 * (sourceY * inputWidth + sourceX)] : pixelAt(input, sourceX, sourceY);
+						row = addPixels(row, scalePixel(loadPixel(sample), weights[i]));
+					}
+
+					color = addPixels(color, scalePixel(row, weights[j]));
+				}
+
+				storePixel(&output.pixels[4 * (y * output.width + x)], saturate(color));
+			}
+		}
+	});
+}
+
+void SoftwareBloomEffect::add(const Buffer& source, const Buffer& bloom, Buffer& output)
+{
+	BOOK_PROFILE_ZONE("SoftwareBloomEffect::add");
+
+	std::vector<SampleTap> columns = computeSampleTaps(output.width, bloom.width);
+	std::vector<SampleTap> rows = computeSampleTaps(output.height, bloom.height);
+
+	mWorkers.run(output.height, MinRowsPerThread, [&] (unsigned int begin, unsigned int end)
+	{
+		for (unsigned int y = begin; y < end; ++y)
+		{
+			for (unsigned int x = 0; x < output.width; ++x)
+			{
+				std::size_t i = 4 * (y * output.width + x);
+				Pixel bloomColor = sampleBilinear(bloom, columns[x], rows[y]);
+
+				storePixel(&output.pixels[i], saturate(addPixels(loadPixel(&source.pixels[i]), bloomColor)));
+			}
+		}
+	});
+}
+
+void SoftwareBloomEffect::addFinal(const sf::Uint8* source, const Buffer& bloom)
+{
+	BOOK_PROFILE_ZONE("SoftwareBloomEffect::addFinal");
+
+	std::vector<SampleTap> columns = computeSampleTaps(mSize.x, bloom.width);
+	std::vector<SampleTap> rows = computeSampleTaps(mSize.y, bloom.height);
+	mResult.resize(4 * mSize.x * mSize.y);
+
+	mWorkers.run(mSize.y, MinRowsPerThread, [&] (unsigned int begin, unsigned int end)
+	{
+		for (unsigned int y = begin; y < end; ++y)
+		{
+			for (unsigned int x = 0; x < mSize.x; ++x)
+			{
+				std::size_t i = 4 * (y * mSize.x + x);
+				Pixel bloomColor = sampleBilinear(bloom, columns[x], rows[y]);
+
+				storePixel(&mResult[i], addPixels(loadPixel(source + i), bloomColor));
+			}
+		}
+	});
+}
+
+void SoftwareBloomEffect::convertBloom(const Buffer& bloom)
+{
+	BOOK_PROFILE_ZONE("SoftwareBloomEffect::convertBloom");
+
+	mResult.resize(4 * bloom.width * bloom.height);
+
+	mWorkers.run(bloom.height, MinRowsPerThread, [&] (unsigned int begin, unsigned int end)
+	{
+		for (std::size_t i = 4 * begin * bloom.width; i < 4 * end * bloom.width; i += 4)
+		{
+			storePixel(&mResult[i], loadPixel(&bloom.pixels[i]));
+
+			// Opaque, so additive blending adds the color unscaled
+			mResult[i + 3] = 255;
+		}
+	});
+}
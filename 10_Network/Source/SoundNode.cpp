@@ -1,19 +1,106 @@
 #include <Book/SoundNode.hpp>
 #include <Book/SoundPlayer.hpp>
+#include <Book/Foreach.hpp>
+#include <Book/Utility.hpp>
+
+#include <algorithm>
+#include <cmath>
 
 
 SoundNode::SoundNode(SoundPlayer& player)
 : SceneNode()
 , mSounds(player)
+, mRequests()
+, mGroups()
+, mWindow(sf::seconds(0.05f))
+, mDistance(150.f)
 {
 }
 
 void SoundNode::playSound(SoundEffect::ID sound, sf::Vector2f position)
 {
-	mSounds.play(sound, position);
+	Request request;
+	request.effect = sound;
+	request.position = position;
+
+	mRequests.push_back(request);
+}
+
+void SoundNode::setCoalescing(sf::Time window, float distance)
+{
+	mWindow = window;
+	mDistance = distance;
 }
 
 unsigned int SoundNode::getCategory() const
 {
 	return Category::SoundEffect;
 }
+
+void SoundNode::updateCurrent(sf::Time dt, CommandQueue&)
+{
+	// Forget played groups that are older than the window
+	FOREACH(Group& group, mGroups)
+		group.age += dt;
+
+	mGroups.erase(std::remove_if(mGroups.begin(), mGroups.end(), [this] (const Group& group)
+	{
+		return group.played && group.age >= mWindow;
+	}), mGroups.end());
+
+	// Merge each request into a waiting group of the same effect nearby, or start a new one
+	FOREACH(const Request& request, mRequests)
+	{
+		auto found = std::find_if(mGroups.begin(), mGroups.end(), [this, &request] (const Group& group)
+		{
+			return !group.played && isNearby(group, request.effect, request.position);
+		});
+
+		if (found == mGroups.end())
+		{
+			Group group;
+			group.effect = request.effect;
+			group.position = request.position;
+			group.count = 1;
+			group.age = sf::Time::Zero;
+			group.played = false;
+
+			mGroups.push_back(group);
+		}
+		else
+		{
+			++found->count;
+			found->position += (request.position - found->position) / static_cast<float>(found->count);
+		}
+	}
+
+	mRequests.clear();
+
+	// A waiting group plays once no voice of its kind nearby is younger than the window. It keeps
+	// merging requests until then, so late requests are heard in the next voice instead of being lost.
+	FOREACH(Group& group, mGroups)
+	{
+		if (group.played)
+			continue;
+
+		auto playing = std::find_if(mGroups.begin(), mGroups.end(), [this, &group] (const Group& other)
+		{
+			return other.played && isNearby(other, group.effect, group.position);
+		});
+
+		if (playing != mGroups.end())
+			continue;
+
+		// Single requests play at full volume, merged ones louder by the power sum
+		float volume = 100.f * std::sqrt(static_cast<float>(group.count));
+		mSounds.play(group.effect, group.position, volume);
+
+		group.played = true;
+		group.age = sf::Time::Zero;
+	}
+}
+
+bool SoundNode::isNearby(const Group& group, SoundEffect::ID effect, sf::Vector2f position) const
+{
+	return group.effect == effect && length(group.position - position) <= mDistance;
+}
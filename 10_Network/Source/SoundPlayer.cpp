@@ -1,7 +1,11 @@
 #include <Book/SoundPlayer.hpp>
+#include <Book/DataTables.hpp>
+#include <Book/Foreach.hpp>
+#include <Book/Utility.hpp>
 
 #include <SFML/Audio/Listener.hpp>
 
+#include <algorithm>
 #include <cmath>
 
 
@@ -13,19 +17,29 @@ namespace
 	const float Attenuation = 8.f;
 	const float MinDistance2D = 200.f;
 	const float MinDistance3D = std::sqrt(MinDistance2D*MinDistance2D + ListenerZ*ListenerZ);
+
+	// Well below the OpenAL source limit of common implementations
+	const std::size_t VoiceCount = 32;
+
+	const std::vector<SoundEffectData> Table = initializeSoundEffectData();
 }
 
-SoundPlayer::SoundPlayer()
+SoundPlayer::SoundPlayer(ResourceLoader& loader, const AssetArchive& archive)
 : mSoundBuffers()
-, mSounds()
+, mVoices(VoiceCount)
+, mSequence(0)
+, mStolenVoices(0)
+, mCulledSounds(0)
 {
-	mSoundBuffers.load(SoundEffect::AlliedGunfire,	"Media/Sound/AlliedGunfire.wav");
-	mSoundBuffers.load(SoundEffect::EnemyGunfire,	"Media/Sound/EnemyGunfire.wav");
-	mSoundBuffers.load(SoundEffect::Explosion1,		"Media/Sound/Explosion1.wav");
-	mSoundBuffers.load(SoundEffect::Explosion2,		"Media/Sound/Explosion2.wav");
-	mSoundBuffers.load(SoundEffect::LaunchMissile,	"Media/Sound/LaunchMissile.wav");
-	mSoundBuffers.load(SoundEffect::CollectPickup,	"Media/Sound/CollectPickup.wav");
-	mSoundBuffers.load(SoundEffect::Button,			"Media/Sound/Button.wav");
+	mSoundBuffers.setArchive(archive);
+
+	mSoundBuffers.loadAsync(loader, SoundEffect::AlliedGunfire,	"Media/Sound/AlliedGunfire.wav");
+	mSoundBuffers.loadAsync(loader, SoundEffect::EnemyGunfire,	"Media/Sound/EnemyGunfire.wav");
+	mSoundBuffers.loadAsync(loader, SoundEffect::Explosion1,	"Media/Sound/Explosion1.wav");
+	mSoundBuffers.loadAsync(loader, SoundEffect::Explosion2,	"Media/Sound/Explosion2.wav");
+	mSoundBuffers.loadAsync(loader, SoundEffect::LaunchMissile,	"Media/Sound/LaunchMissile.wav");
+	mSoundBuffers.loadAsync(loader, SoundEffect::CollectPickup,	"Media/Sound/CollectPickup.wav");
+	mSoundBuffers.loadAsync(loader, SoundEffect::Button,		"Media/Sound/Button.wav");
 
 	// Listener points towards the screen (default in SFML)
 	sf::Listener::setDirection(0.f, 0.f, -1.f);
@@ -36,27 +50,44 @@ void SoundPlayer::play(SoundEffect::ID effect)
 	play(effect, getListenerPosition());
 }
 
-void SoundPlayer::play(SoundEffect::ID effect, sf::Vector2f position)
+void SoundPlayer::play(SoundEffect::ID effect, sf::Vector2f position, float volume)
 {
-	mSounds.push_back(sf::Sound());
-	sf::Sound& sound = mSounds.back();
+	// Effects still decoding in the background are not played
+	if (!mSoundBuffers.contains(effect))
+		return;
+
+	const SoundEffectData& data = Table[effect];
+	if (length(position - getListenerPosition()) > data.cullDistance)
+	{
+		++mCulledSounds;
+		return;
+	}
+
+	float gain = computeGain(position) * volume / 100.f;
+	Voice* voice = findVoice(effect, data.priority, gain);
+	if (!voice)
+	{
+		++mCulledSounds;
+		return;
+	}
+
+	voice->effect = effect;
+	voice->priority = data.priority;
+	voice->gain = gain;
+	voice->sequence = mSequence++;
 
+	sf::Sound& sound = voice->sound;
+	sound.stop();
 	sound.setBuffer(mSoundBuffers.get(effect));
 	sound.setPosition(position.x, -position.y, 0.f);
+	// The gain of a source can't exceed 1; louder voices keep full volume over a wider radius instead
+	sound.setVolume(std::min(volume, 100.f));
 	sound.setAttenuation(Attenuation);
-	sound.setMinDistance(MinDistance3D);
+	sound.setMinDistance(MinDistance3D * std::max(volume / 100.f, 1.f));
 
 	sound.play();
 }
 
-void SoundPlayer::removeStoppedSounds()
-{
-	mSounds.remove_if([] (const sf::Sound& s)
-	{
-		return s.getStatus() == sf::Sound::Stopped;
-	});
-}
-
 void SoundPlayer::setListenerPosition(sf::Vector2f position)
 {
 	sf::Listener::setPosition(position.x, -position.y, ListenerZ);
@@ -67,3 +98,93 @@ sf::Vector2f SoundPlayer::getListenerPosition() const
 	sf::Vector3f position = sf::Listener::getPosition();
 	return sf::Vector2f(position.x, -position.y);
 }
+
+std::size_t SoundPlayer::getActiveVoiceCount() const
+{
+	std::size_t count = 0;
+	FOREACH(const Voice& voice, mVoices)
+	{
+		if (voice.sound.getStatus() != sf::Sound::Stopped)
+			++count;
+	}
+
+	return count;
+}
+
+std::size_t SoundPlayer::getVoiceCount() const
+{
+	return mVoices.size();
+}
+
+std::size_t SoundPlayer::getStolenVoiceCount() const
+{
+	return mStolenVoices;
+}
+
+std::size_t SoundPlayer::getCulledSoundCount() const
+{
+	return mCulledSounds;
+}
+
+SoundPlayer::Voice* SoundPlayer::findVoice(SoundEffect::ID effect, int priority, float gain)
+{
+	// At the effect's cap, restart its oldest voice
+	Voice* oldestSameEffect = nullptr;
+	std::size_t sameEffectCount = 0;
+
+	Voice* freeVoice = nullptr;
+	Voice* victim = nullptr;
+
+	FOREACH(Voice& voice, mVoices)
+	{
+		if (voice.sound.getStatus() == sf::Sound::Stopped)
+		{
+			if (!freeVoice)
+				freeVoice = &voice;
+
+			continue;
+		}
+
+		if (voice.effect == effect)
+		{
+			++sameEffectCount;
+			if (!oldestSameEffect || voice.sequence < oldestSameEffect->sequence)
+				oldestSameEffect = &voice;
+		}
+
+		// Steal candidates: lowest priority, then quietest, then oldest
+		if (!victim
+		 || voice.priority < victim->priority
+		 || (voice.priority == victim->priority && voice.gain < victim->gain)
+		 || (voice.priority == victim->priority && voice.gain == victim->gain && voice.sequence < victim->sequence))
+			victim = &voice;
+	}
+
+	if (sameEffectCount >= Table[effect].maxVoices)
+	{
+		++mStolenVoices;
+		return oldestSameEffect;
+	}
+
+	if (freeVoice)
+		return freeVoice;
+
+	// Only steal from less important or quieter sounds
+	if (victim && (victim->priority < priority || (victim->priority == priority && victim->gain <= gain)))
+	{
+		++mStolenVoices;
+		return victim;
+	}
+
+	return nullptr;
+}
+
+float SoundPlayer::computeGain(sf::Vector2f position) const
+{
+	// OpenAL's inverse distance clamped model, as configured for each sound
+	sf::Vector2f offset = position - getListenerPosition();
+	float distance = std::sqrt(offset.x * offset.x + offset.y * offset.y + ListenerZ * ListenerZ);
+	distance = std::max(distance, MinDistance3D);
+
+	return MinDistance3D / (MinDistance3D + Attenuation * (distance - MinDistance3D));
+}
@@ -16,4 +16,9 @@ SpriteNode::SpriteNode(const sf::Texture& texture, const sf::IntRect& textureRec
 void SpriteNode::drawCurrent(sf::RenderTarget& target, sf::RenderStates states) const
 {
 	target.draw(mSprite, states);
+}
+
+void SpriteNode::collectCurrentStatistics(SceneStatistics& statistics) const
+{
+	++statistics.drawCalls;
 }
\ No newline at end of file
@@ -2,15 +2,20 @@
 #include <Book/StateStack.hpp>
 
 
-State::Context::Context(sf::RenderWindow& window, TextureHolder& textures, FontHolder& fonts,
-	MusicPlayer& music, SoundPlayer& sounds, KeyBinding& keys1, KeyBinding& keys2)
+State::Context::Context(sf::RenderWindow& window, TextureHolder& textures, FontHolder& fonts, ShaderHolder& shaders,
+	MusicPlayer& music, SoundPlayer& sounds, KeyBinding& keys1, KeyBinding& keys2,
+	Statistics& statistics, ResourceLoader& loader, float minResolutionScale)
 : window(&window)
 , textures(&textures)
 , fonts(&fonts)
+, shaders(&shaders)
 , music(&music)
 , sounds(&sounds)
 , keys1(&keys1)
 , keys2(&keys2)
+, statistics(&statistics)
+, loader(&loader)
+, minResolutionScale(minResolutionScale)
 {
 }
 
@@ -53,3 +58,8 @@ void State::onDestroy()
 {
 
 }
+
+void State::setInterpolation(float)
+{
+	// Do nothing by default
+}
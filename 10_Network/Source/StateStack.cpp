@@ -9,15 +9,18 @@ StateStack::StateStack(State::Context context)
 , mPendingList()
 , mContext(context)
 , mFactories()
+, mFirstUpdated(0)
 {
 }
 
 void StateStack::update(sf::Time dt)
 {
 	// Iterate from top to bottom, stop as soon as update() returns false
-	for (auto itr = mStack.rbegin(); itr != mStack.rend(); ++itr)
+	mFirstUpdated = mStack.size();
+	while (mFirstUpdated > 0)
 	{
-		if (!(*itr)->update(dt))
+		--mFirstUpdated;
+		if (!mStack[mFirstUpdated]->update(dt))
 			break;
 	}
 
@@ -43,6 +46,13 @@ void StateStack::handleEvent(const sf::Event& event)
 	applyPendingChanges();
 }
 
+void StateStack::setInterpolation(float alpha)
+{
+	// States below a blocking state were not stepped, interpolating them would replay their last step
+	for (std::size_t i = 0; i < mStack.size(); ++i)
+		mStack[i]->setInterpolation(i < mFirstUpdated ? 1.f : alpha);
+}
+
 void StateStack::pushState(States::ID stateID)
 {
 	mPendingList.push_back(PendingChange(Push, stateID));
@@ -0,0 +1,28 @@
+#include <Book/Statistics.hpp>
+#include <Book/Foreach.hpp>
+
+
+Statistics::Statistics()
+: mValues()
+{
+}
+
+void Statistics::setValue(const std::string& name, const std::string& value)
+{
+	mValues[name] = value;
+}
+
+void Statistics::removeValue(const std::string& name)
+{
+	mValues.erase(name);
+}
+
+std::string Statistics::getText() const
+{
+	// One "Name: value" line per entry
+	std::string text;
+	FOREACH(auto& pair, mValues)
+		text += pair.first + ": " + pair.second + "\n";
+
+	return text;
+}
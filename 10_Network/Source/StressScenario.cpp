@@ -0,0 +1,114 @@
+#include <Book/StressScenario.hpp>
+#include <Book/Utility.hpp>
+
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+
+namespace
+{
+	const char* AircraftNames[] = { "Eagle", "Raptor", "Avenger" };
+	const char* ProjectileNames[] = { "AlliedBullet", "EnemyBullet", "Missile" };
+	const char* ParticleNames[] = { "Propellant", "Smoke" };
+
+	// Reads "<type name> <count>"; the name tables and count arrays have one entry per type
+	template <std::size_t N>
+	bool readCount(std::istream& stream, const char* (&names)[N], std::array<std::size_t, N>& counts)
+	{
+		std::string type;
+		std::size_t count;
+		if (!(stream >> type >> count))
+			return false;
+
+		for (std::size_t i = 0; i < N; ++i)
+		{
+			if (type == names[i])
+			{
+				counts[i] = count;
+				return true;
+			}
+		}
+
+		return false;
+	}
+}
+
+StressScenario::Population::Population()
+: enemies()
+, projectiles()
+, pickups(0)
+, emitters()
+{
+	enemies.fill(0);
+	projectiles.fill(0);
+	emitters.fill(0);
+}
+
+StressScenario::StressScenario()
+: name()
+, duration(sf::seconds(20.f))
+, seed(0)
+, population()
+{
+}
+
+void StressScenario::loadFromFile(const std::string& filename)
+{
+	std::ifstream file(filename.c_str());
+	if (!file)
+		throw std::runtime_error("StressScenario::loadFromFile - Failed to open " + filename);
+
+	*this = StressScenario();
+	name = filename;
+
+	std::string line;
+	for (std::size_t lineNumber = 1; std::getline(file, line); ++lineNumber)
+	{
+		std::istringstream stream(line);
+		std::string key;
+
+		// Empty lines and comments
+		if (!(stream >> key) || key[0] == '#')
+			continue;
+
+		bool valid = false;
+		if (key == "name")
+		{
+			valid = static_cast<bool>(stream >> name);
+		}
+		else if (key == "duration")
+		{
+			float seconds = 0.f;
+			valid = (stream >> seconds) && seconds > 0.f;
+			duration = sf::seconds(seconds);
+		}
+		else if (key == "seed")
+		{
+			valid = static_cast<bool>(stream >> seed);
+		}
+		else if (key == "pickups")
+		{
+			valid = static_cast<bool>(stream >> population.pickups);
+		}
+		else if (key == "enemies")
+		{
+			valid = readCount(stream, AircraftNames, population.enemies);
+		}
+		else if (key == "projectiles")
+		{
+			valid = readCount(stream, ProjectileNames, population.projectiles);
+		}
+		else if (key == "emitters")
+		{
+			valid = readCount(stream, ParticleNames, population.emitters);
+		}
+
+		if (!valid)
+			throw std::runtime_error("StressScenario::loadFromFile - " + filename + ":" + toString(lineNumber) + ": cannot parse '" + line + "'");
+	}
+
+	// Eagles are allied, World would neither count nor remove them as enemies
+	if (population.enemies[Aircraft::Eagle] > 0)
+		throw std::runtime_error("StressScenario::loadFromFile - " + filename + ": Eagle is not an enemy type");
+}
@@ -16,6 +16,11 @@ void TextNode::drawCurrent(sf::RenderTarget& target, sf::RenderStates states) co
 	target.draw(mText, states);
 }
 
+void TextNode::collectCurrentStatistics(SceneStatistics& statistics) const
+{
+	++statistics.drawCalls;
+}
+
 void TextNode::setString(const std::string& text)
 {
 	mText.setString(text);
@@ -1,6 +1,7 @@
 #include <Book/TitleState.hpp>
 #include <Book/Utility.hpp>
 #include <Book/ResourceHolder.hpp>
+#include <Book/MusicPlayer.hpp>
 
 #include <SFML/Graphics/RenderWindow.hpp>
 
@@ -17,6 +18,9 @@ TitleState::TitleState(StateStack& stack, Context context)
 	mText.setString("Press any key to start");
 	centerOrigin(mText);
 	mText.setPosition(sf::Vector2f(context.window->getSize() / 2u));
+
+	// Open the menu theme while the title is shown
+	context.music->prefetch(Music::MenuTheme);
 }
 
 void TitleState::draw()
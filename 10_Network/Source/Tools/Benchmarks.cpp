@@ -0,0 +1,517 @@
+#include <Book/Aircraft.hpp>
+#include <Book/Projectile.hpp>
+#include <Book/ParticleNode.hpp>
+#include <Book/SceneNode.hpp>
+#include <Book/CommandQueue.hpp>
+#include <Book/KeyBinding.hpp>
+#include <Book/NetworkProtocol.hpp>
+#include <Book/ResourceHolder.hpp>
+#include <Book/Foreach.hpp>
+
+#include <SFML/Config.hpp>
+#include <SFML/System/Clock.hpp>
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/Texture.hpp>
+#include <SFML/Graphics/Font.hpp>
+#include <SFML/Network/Packet.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+
+// Usage: Benchmarks [<output.json>] [<name filter>]
+// Loads textures and fonts from Media/, so run it from the chapter directory. No window is opened.
+// Results are written as JSON (to stdout without an output file), progress goes to stderr.
+namespace
+{
+	// Each benchmark is sampled several times, the median sample is reported
+	const std::size_t SampleCount = 5;
+	const sf::Time MinSampleTime = sf::milliseconds(50);
+
+	const sf::Time UpdateStep = sf::seconds(1.f / 60.f);
+	const sf::FloatRect Battlefield(0.f, 0.f, 1024.f, 768.f);
+
+	// Results are accumulated here, so the compiler cannot drop the measured work
+	volatile std::size_t sink = 0;
+
+	struct Result
+	{
+		std::string			name;
+		std::size_t			size;			// Entity, particle or element count the benchmark works on
+		std::size_t			iterations;		// Per sample
+		double				nanoseconds;	// Median time per iteration
+	};
+
+	// Never active, so sf::RenderTarget returns from draw() before issuing OpenGL calls,
+	// only the scene traversal and vertex preparation are measured.
+	// SFML 2.5 replaced the private activate() hook by the public, virtual setActive().
+	class NullRenderTarget : public sf::RenderTarget
+	{
+		public:
+			virtual sf::Vector2u getSize() const
+			{
+				return sf::Vector2u(1024, 768);
+			}
+
+#if SFML_VERSION_MAJOR > 2 || (SFML_VERSION_MAJOR == 2 && SFML_VERSION_MINOR >= 5)
+			virtual bool setActive(bool = true)
+			{
+				return false;
+			}
+#else
+		private:
+			virtual bool activate(bool)
+			{
+				return false;
+			}
+#endif
+	};
+
+	class BenchmarkRunner
+	{
+		public:
+			explicit BenchmarkRunner(const std::string& filter)
+			: mFilter(filter)
+			, mResults()
+			{
+			}
+
+			template <typename Function>
+			void run(const std::string& name, std::size_t size, Function function)
+			{
+				if (name.find(mFilter) == std::string::npos)
+					return;
+
+				// Grow the batch until a sample is well above the clock's resolution
+				std::size_t iterations = 1;
+				while (measure(function, iterations) < MinSampleTime)
+					iterations *= 2;
+
+				std::vector<double> samples;
+				for (std::size_t i = 0; i < SampleCount; ++i)
+					samples.push_back(measure(function, iterations).asMicroseconds() * 1000.0 / iterations);
+
+				std::nth_element(samples.begin(), samples.begin() + SampleCount / 2, samples.end());
+
+				Result result = { name, size, iterations, samples[SampleCount / 2] };
+				mResults.push_back(result);
+
+				std::cerr << name << " [" << size << "]: " << result.nanoseconds << " ns" << std::endl;
+			}
+
+			void write(std::ostream& stream) const
+			{
+				stream << "{\n\t\"benchmarks\": [";
+				for (std::size_t i = 0; i < mResults.size(); ++i)
+				{
+					const Result& result = mResults[i];
+					stream << (i == 0 ? "\n" : ",\n")
+						<< "\t\t{ \"name\": \"" << result.name << "\", \"size\": " << result.size
+						<< ", \"iterations\": " << result.iterations << ", \"nanoseconds\": " << result.nanoseconds << " }";
+				}
+				stream << "\n\t]\n}\n";
+			}
+
+		private:
+			template <typename Function>
+			sf::Time measure(Function& function, std::size_t iterations)
+			{
+				sf::Clock clock;
+				for (std::size_t i = 0; i < iterations; ++i)
+					function();
+
+				return clock.getElapsedTime();
+			}
+
+		private:
+			std::string			mFilter;
+			std::vector<Result>	mResults;
+	};
+
+	// Root node with an air layer holding aircraft and projectiles, half each, spread over the battlefield
+	SceneNode::Ptr createScene(std::size_t entityCount, const TextureHolder& textures, const FontHolder& fonts)
+	{
+		std::default_random_engine engine(entityCount);
+		std::uniform_real_distribution<float> x(Battlefield.left, Battlefield.left + Battlefield.width);
+		std::uniform_real_distribution<float> y(Battlefield.top, Battlefield.top + Battlefield.height);
+
+		SceneNode::Ptr root(new SceneNode());
+		std::unique_ptr<SceneNode> airLayer(new SceneNode(Category::SceneAirLayer));
+
+		for (std::size_t i = 0; i < entityCount; ++i)
+		{
+			SceneNode::Ptr entity;
+			if (i % 2 == 0)
+				entity.reset(new Aircraft(i % 4 == 0 ? Aircraft::Eagle : Aircraft::Raptor, textures, fonts));
+			else
+				entity.reset(new Projectile(i % 4 == 1 ? Projectile::AlliedBullet : Projectile::EnemyBullet, textures));
+
+			entity->setPosition(x(engine), y(engine));
+			airLayer->attachChild(std::move(entity));
+		}
+
+		root->attachChild(std::move(airLayer));
+		return root;
+	}
+
+	void drainCommands(CommandQueue& commands)
+	{
+		while (!commands.isEmpty())
+			commands.pop();
+	}
+
+	void benchmarkScene(BenchmarkRunner& runner, const TextureHolder& textures, const FontHolder& fonts)
+	{
+		const std::size_t entityCounts[] = { 100, 400, 1600 };
+		for (std::size_t i = 0; i < 3; ++i)
+		{
+			std::size_t entityCount = entityCounts[i];
+			SceneNode::Ptr scene = createScene(entityCount, textures, fonts);
+			CommandQueue commands;
+			NullRenderTarget target;
+
+			runner.run("SceneNode::update", entityCount, [&] ()
+			{
+				scene->update(UpdateStep, commands);
+				drainCommands(commands);
+			});
+
+			runner.run("SceneNode::draw", entityCount, [&] ()
+			{
+				target.draw(*scene);
+			});
+		}
+
+		// Quadratic in the entity count, so kept smaller
+		const std::size_t collisionCounts[] = { 50, 200, 800 };
+		for (std::size_t i = 0; i < 3; ++i)
+		{
+			std::size_t entityCount = collisionCounts[i];
+			SceneNode::Ptr scene = createScene(entityCount, textures, fonts);
+			std::set<SceneNode::Pair> collisionPairs;
+
+			runner.run("SceneNode::checkSceneCollision", entityCount, [&] ()
+			{
+				std::size_t testCount = 0;
+				collisionPairs.clear();
+				scene->checkSceneCollision(*scene, collisionPairs, testCount);
+				sink += collisionPairs.size() + testCount;
+			});
+		}
+	}
+
+	void benchmarkCommands(BenchmarkRunner& runner, const TextureHolder& textures, const FontHolder& fonts)
+	{
+		const std::size_t commandCount = 1000;
+
+		Command command;
+		command.category = Category::EnemyAircraft;
+		command.action = [] (SceneNode& node, sf::Time)
+		{
+			sink += node.getCategory();
+		};
+
+		CommandQueue commands;
+		runner.run("CommandQueue::push/pop", commandCount, [&] ()
+		{
+			for (std::size_t i = 0; i < commandCount; ++i)
+				commands.push(command);
+
+			drainCommands(commands);
+		});
+
+		// Every command is offered to every node of the scene
+		const std::size_t entityCounts[] = { 100, 400 };
+		for (std::size_t i = 0; i < 2; ++i)
+		{
+			std::size_t entityCount = entityCounts[i];
+			SceneNode::Ptr scene = createScene(entityCount, textures, fonts);
+			runner.run("SceneNode::onCommand", entityCount, [&] ()
+			{
+				for (std::size_t j = 0; j < 10; ++j)
+					commands.push(command);
+
+				while (!commands.isEmpty())
+					scene->onCommand(commands.pop(), UpdateStep);
+			});
+		}
+	}
+
+	void benchmarkParticles(BenchmarkRunner& runner, const TextureHolder& textures)
+	{
+		std::default_random_engine engine;
+		std::uniform_real_distribution<float> x(Battlefield.left, Battlefield.left + Battlefield.width);
+		std::uniform_real_distribution<float> y(Battlefield.top, Battlefield.top + Battlefield.height);
+
+		const std::size_t particleCounts[] = { 256, 1024, 4096 };
+		for (std::size_t i = 0; i < 3; ++i)
+		{
+			// Smoke has the largest capacity
+			ParticleNode particles(Particle::Smoke, textures);
+			for (std::size_t j = 0; j < particleCounts[i]; ++j)
+				particles.addParticle(sf::Vector2f(x(engine), y(engine)));
+
+			CommandQueue commands;
+			NullRenderTarget target;
+
+			// A zero time step expires nothing, but makes the next draw recompute all vertices
+			runner.run("ParticleNode::computeVertices", particles.getParticleCount(), [&] ()
+			{
+				particles.update(sf::Time::Zero, commands);
+				target.draw(particles);
+			});
+		}
+	}
+
+	void benchmarkResources(BenchmarkRunner& runner, const TextureHolder& textures)
+	{
+		const Textures::ID ids[] = { Textures::Entities, Textures::Explosion, Textures::Particle };
+		const std::size_t idCount = sizeof(ids) / sizeof(ids[0]);
+
+		runner.run("ResourceHolder::get", idCount, [&] ()
+		{
+			for (std::size_t i = 0; i < idCount; ++i)
+				sink += textures.get(ids[i]).getSize().x;
+		});
+
+		runner.run("ResourceHolder::contains", idCount, [&] ()
+		{
+			for (std::size_t i = 0; i < idCount; ++i)
+				sink += textures.contains(ids[i]);
+		});
+	}
+
+	struct PacketFormat
+	{
+		std::string							name;
+		std::function<void(sf::Packet&)>	encode;
+		std::function<void(sf::Packet&)>	decode;
+	};
+
+	// Same fields and types as GameServer, Player and MultiplayerGameState exchange
+	std::vector<PacketFormat> initializePacketFormats()
+	{
+		const sf::Int32 aircraftCount = 4;
+
+		std::vector<PacketFormat> formats;
+		auto add = [&formats] (const std::string& name, std::function<void(sf::Packet&)> encode, std::function<void(sf::Packet&)> decode)
+		{
+			PacketFormat format = { name, encode, decode };
+			formats.push_back(format);
+		};
+
+		// [Int32:identifier] [float:x] [float:y], used by several server packets
+		auto encodeAircraftPosition = [] (sf::Packet& packet)
+		{
+			packet << sf::Int32(1) << 512.f << 384.f;
+		};
+		auto decodeAircraftPosition = [] (sf::Packet& packet)
+		{
+			sf::Int32 identifier; float x, y;
+			packet >> identifier >> x >> y;
+			sink += identifier;
+		};
+
+		add("Server::BroadcastMessage",
+			[] (sf::Packet& packet) { packet << sf::Int32(Server::BroadcastMessage) << std::string("New player!"); },
+			[] (sf::Packet& packet) { sf::Int32 type; std::string message; packet >> type >> message; sink += message.size(); });
+
+		add("Server::SpawnSelf",
+			[=] (sf::Packet& packet) { packet << sf::Int32(Server::SpawnSelf); encodeAircraftPosition(packet); },
+			[=] (sf::Packet& packet) { sf::Int32 type; packet >> type; decodeAircraftPosition(packet); });
+
+		add("Server::InitialState",
+			[=] (sf::Packet& packet)
+			{
+				packet << sf::Int32(Server::InitialState) << 5000.f << 768.f << aircraftCount;
+				for (sf::Int32 i = 0; i < aircraftCount; ++i)
+					packet << i << 512.f << 384.f << sf::Int32(100) << sf::Int32(2);
+			},
+			[] (sf::Packet& packet)
+			{
+				sf::Int32 type, count; float worldHeight, currentScroll;
+				packet >> type >> worldHeight >> currentScroll >> count;
+				for (sf::Int32 i = 0; i < count; ++i)
+				{
+					sf::Int32 identifier, hitpoints, missileAmmo; float x, y;
+					packet >> identifier >> x >> y >> hitpoints >> missileAmmo;
+					sink += hitpoints;
+				}
+			});
+
+		add("Server::PlayerEvent",
+			[] (sf::Packet& packet) { packet << sf::Int32(Server::PlayerEvent) << sf::Int32(1) << sf::Int32(PlayerAction::LaunchMissile); },
+			[] (sf::Packet& packet) { sf::Int32 type, identifier, action; packet >> type >> identifier >> action; sink += action; });
+
+		add("Server::PlayerRealtimeChange",
+			[] (sf::Packet& packet) { packet << sf::Int32(Server::PlayerRealtimeChange) << sf::Int32(1) << sf::Int32(PlayerAction::Fire) << true; },
+			[] (sf::Packet& packet) { sf::Int32 type, identifier, action; bool enabled; packet >> type >> identifier >> action >> enabled; sink += enabled; });
+
+		add("Server::PlayerConnect",
+			[=] (sf::Packet& packet) { packet << sf::Int32(Server::PlayerConnect); encodeAircraftPosition(packet); },
+			[=] (sf::Packet& packet) { sf::Int32 type; packet >> type; decodeAircraftPosition(packet); });
+
+		add("Server::PlayerDisconnect",
+			[] (sf::Packet& packet) { packet << sf::Int32(Server::PlayerDisconnect) << sf::Int32(1); },
+			[] (sf::Packet& packet) { sf::Int32 type, identifier; packet >> type >> identifier; sink += identifier; });
+
+		add("Server::AcceptCoopPartner",
+			[=] (sf::Packet& packet) { packet << sf::Int32(Server::AcceptCoopPartner); encodeAircraftPosition(packet); },
+			[=] (sf::Packet& packet) { sf::Int32 type; packet >> type; decodeAircraftPosition(packet); });
+
+		add("Server::SpawnEnemy",
+			[] (sf::Packet& packet) { packet << sf::Int32(Server::SpawnEnemy) << sf::Int32(Aircraft::Raptor) << 1200.f << 100.f; },
+			[] (sf::Packet& packet) { sf::Int32 type, aircraftType; float height, relativeX; packet >> type >> aircraftType >> height >> relativeX; sink += aircraftType; });
+
+		add("Server::SpawnPickup",
+			[] (sf::Packet& packet) { packet << sf::Int32(Server::SpawnPickup) << sf::Int32(0) << 512.f << 384.f; },
+			[] (sf::Packet& packet) { sf::Int32 type, pickupType; float x, y; packet >> type >> pickupType >> x >> y; sink += pickupType; });
+
+		add("Server::UpdateClientState",
+			[=] (sf::Packet& packet)
+			{
+				packet << sf::Int32(Server::UpdateClientState) << 768.f << aircraftCount;
+				for (sf::Int32 i = 0; i < aircraftCount; ++i)
+					packet << i << 512.f << 384.f;
+			},
+			[=] (sf::Packet& packet)
+			{
+				sf::Int32 type, count; float currentWorldPosition;
+				packet >> type >> currentWorldPosition >> count;
+				for (sf::Int32 i = 0; i < count; ++i)
+					decodeAircraftPosition(packet);
+			});
+
+		add("Server::MissionSuccess",
+			[] (sf::Packet& packet) { packet << sf::Int32(Server::MissionSuccess); },
+			[] (sf::Packet& packet) { sf::Int32 type; packet >> type; sink += type; });
+
+		add("Client::PlayerEvent",
+			[] (sf::Packet& packet) { packet << sf::Int32(Client::PlayerEvent) << sf::Int32(1) << sf::Int32(PlayerAction::LaunchMissile); },
+			[] (sf::Packet& packet) { sf::Int32 type, identifier, action; packet >> type >> identifier >> action; sink += action; });
+
+		add("Client::PlayerRealtimeChange",
+			[] (sf::Packet& packet) { packet << sf::Int32(Client::PlayerRealtimeChange) << sf::Int32(1) << sf::Int32(PlayerAction::Fire) << true; },
+			[] (sf::Packet& packet) { sf::Int32 type, identifier, action; bool enabled; packet >> type >> identifier >> action >> enabled; sink += enabled; });
+
+		add("Client::RequestCoopPartner",
+			[] (sf::Packet& packet) { packet << sf::Int32(Client::RequestCoopPartner); },
+			[] (sf::Packet& packet) { sf::Int32 type; packet >> type; sink += type; });
+
+		add("Client::PositionUpdate",
+			[] (sf::Packet& packet)
+			{
+				packet << sf::Int32(Client::PositionUpdate) << sf::Int32(2);
+				for (sf::Int32 i = 0; i < 2; ++i)
+					packet << i << 512.f << 384.f << sf::Int32(100) << sf::Int32(2);
+			},
+			[] (sf::Packet& packet)
+			{
+				sf::Int32 type, count;
+				packet >> type >> count;
+				for (sf::Int32 i = 0; i < count; ++i)
+				{
+					sf::Int32 identifier, hitpoints, missileAmmo; float x, y;
+					packet >> identifier >> x >> y >> hitpoints >> missileAmmo;
+					sink += hitpoints;
+				}
+			});
+
+		add("Client::GameEvent",
+			[] (sf::Packet& packet) { packet << sf::Int32(Client::GameEvent) << sf::Int32(GameActions::EnemyExplode) << 512.f << 384.f; },
+			[] (sf::Packet& packet) { sf::Int32 type, action; float x, y; packet >> type >> action >> x >> y; sink += action; });
+
+		add("Client::Quit",
+			[] (sf::Packet& packet) { packet << sf::Int32(Client::Quit); },
+			[] (sf::Packet& packet) { sf::Int32 type; packet >> type; sink += type; });
+
+		return formats;
+	}
+
+	void benchmarkPackets(BenchmarkRunner& runner)
+	{
+		std::vector<PacketFormat> formats = initializePacketFormats();
+		FOREACH(const PacketFormat& format, formats)
+		{
+			sf::Packet encoded;
+			format.encode(encoded);
+
+			runner.run("sf::Packet encode " + format.name, encoded.getDataSize(), [&] ()
+			{
+				sf::Packet packet;
+				format.encode(packet);
+				sink += packet.getDataSize();
+			});
+
+			// sf::Packet cannot rewind, so decoding includes the encoding above
+			runner.run("sf::Packet encode+decode " + format.name, encoded.getDataSize(), [&] ()
+			{
+				sf::Packet packet;
+				format.encode(packet);
+				format.decode(packet);
+				sink += packet.endOfPacket();
+			});
+		}
+	}
+
+	void benchmarkKeyBinding(BenchmarkRunner& runner)
+	{
+		KeyBinding binding(1);
+		runner.run("KeyBinding::getRealtimeActions", PlayerAction::Count, [&] ()
+		{
+			sink += binding.getRealtimeActions().size();
+		});
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	std::string outputFile = argc > 1 ? argv[1] : "";
+	std::string filter = argc > 2 ? argv[2] : "";
+
+	try
+	{
+		TextureHolder textures;
+		textures.load(Textures::Entities,	"Media/Textures/Entities.png");
+		textures.load(Textures::Explosion,	"Media/Textures/Explosion.png");
+		textures.load(Textures::Particle,	"Media/Textures/Particle.png");
+
+		FontHolder fonts;
+		fonts.load(Fonts::Main,				"Media/Sansation.ttf");
+
+		BenchmarkRunner runner(filter);
+		benchmarkScene(runner, textures, fonts);
+		benchmarkCommands(runner, textures, fonts);
+		benchmarkParticles(runner, textures);
+		benchmarkResources(runner, textures);
+		benchmarkPackets(runner);
+		benchmarkKeyBinding(runner);
+
+		if (outputFile.empty())
+		{
+			runner.write(std::cout);
+		}
+		else
+		{
+			std::ofstream output(outputFile.c_str());
+			runner.write(output);
+			if (!output)
+			{
+				std::cerr << "Failed to write " << outputFile << std::endl;
+				return 1;
+			}
+		}
+	}
+	catch (std::exception& e)
+	{
+		std::cerr << "EXCEPTION: " << e.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,27 @@
+#include <Book/AssetArchive.hpp>
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+
+// Usage: PackAssets <archive> <file>...
+// File paths are stored as given, so run it from the chapter directory with paths like Media/Sound/Button.wav
+int main(int argc, char* argv[])
+{
+	if (argc < 3)
+	{
+		std::cerr << "Usage: " << argv[0] << " <archive> <file>..." << std::endl;
+		return 1;
+	}
+
+	std::vector<std::string> inputFiles(argv + 2, argv + argc);
+	if (!AssetArchive::pack(argv[1], inputFiles))
+	{
+		std::cerr << "Failed to write " << argv[1] << std::endl;
+		return 1;
+	}
+
+	std::cout << "Packed " << inputFiles.size() << " files into " << argv[1] << std::endl;
+	return 0;
+}
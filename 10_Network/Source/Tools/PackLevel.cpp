@@ -0,0 +1,78 @@
+#include <Book/Level.hpp>
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+
+namespace
+{
+	const char* AircraftNames[] = { "Eagle", "Raptor", "Avenger" };
+
+	bool readSpawn(const std::string& line, Level::Spawn& spawn)
+	{
+		std::istringstream stream(line);
+		std::string type;
+		if (!(stream >> type >> spawn.x >> spawn.distance))
+			return false;
+
+		// The player's aircraft cannot be spawned as an enemy
+		for (std::size_t i = Aircraft::Raptor; i < Aircraft::TypeCount; ++i)
+		{
+			if (type == AircraftNames[i])
+			{
+				spawn.type = static_cast<Aircraft::Type>(i);
+				return true;
+			}
+		}
+
+		return false;
+	}
+}
+
+// Usage: PackLevel <level.txt> <level.lvl>
+// Converts a text spawn list (see Media/Levels/Mission.txt) into the binary level format read by World
+int main(int argc, char* argv[])
+{
+	if (argc != 3)
+	{
+		std::cerr << "Usage: " << argv[0] << " <level.txt> <level.lvl>" << std::endl;
+		return 1;
+	}
+
+	std::ifstream input(argv[1]);
+	if (!input)
+	{
+		std::cerr << "Failed to open " << argv[1] << std::endl;
+		return 1;
+	}
+
+	std::vector<Level::Spawn> spawns;
+	std::string line;
+	for (std::size_t lineNumber = 1; std::getline(input, line); ++lineNumber)
+	{
+		std::size_t start = line.find_first_not_of(" \t\r");
+		if (start == std::string::npos || line[start] == '#')
+			continue;
+
+		Level::Spawn spawn;
+		if (!readSpawn(line, spawn))
+		{
+			std::cerr << argv[1] << ":" << lineNumber << ": Expected '<Raptor|Avenger> <x> <distance>'" << std::endl;
+			return 1;
+		}
+
+		spawns.push_back(spawn);
+	}
+
+	if (!Level::save(argv[2], spawns))
+	{
+		std::cerr << "Failed to write " << argv[2] << std::endl;
+		return 1;
+	}
+
+	std::cout << "Wrote " << spawns.size() << " spawns to " << argv[2] << std::endl;
+	return 0;
+}
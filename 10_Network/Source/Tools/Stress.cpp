@@ -0,0 +1,218 @@
+#include <Book/World.hpp>
+#include <Book/StressScenario.hpp>
+#include <Book/ResourceHolder.hpp>
+#include <Book/ResourceLoader.hpp>
+#include <Book/AssetArchive.hpp>
+#include <Book/SoundPlayer.hpp>
+#include <Book/Statistics.hpp>
+#include <Book/Foreach.hpp>
+
+#include <SFML/System/Clock.hpp>
+#include <SFML/System/Sleep.hpp>
+#include <SFML/Graphics/RenderWindow.hpp>
+#include <SFML/Graphics/RenderTexture.hpp>
+#include <SFML/Graphics/Font.hpp>
+#include <SFML/Graphics/Shader.hpp>
+#include <SFML/Graphics/Texture.hpp>
+#include <SFML/Window/Event.hpp>
+
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+
+// Usage: Stress <scenario> [<report.json>] [--window]
+// Runs a World filled according to the scenario file for its duration, in fixed steps as fast as possible.
+// Renders off-screen unless --window is given. Run it from the chapter directory, Media/ must be reachable.
+namespace
+{
+	const sf::Time TimePerFrame = sf::seconds(1.f / 60.f);
+	const unsigned int Width = 1024;
+	const unsigned int Height = 768;
+
+	const char* PhaseNames[] = { "commands", "collisions", "removeWrecks", "spawn", "graphUpdate", "sounds", "drawScene", "postEffects" };
+
+	// Frame times and per-phase times of every frame, summarized as percentiles
+	class StressReport
+	{
+		public:
+			StressReport()
+			: mFrameTimes()
+			, mPhaseTimes()
+			{
+			}
+
+			void addFrame(sf::Time frameTime, const World& world)
+			{
+				mFrameTimes.push_back(frameTime);
+				for (std::size_t phase = 0; phase < World::PhaseCount; ++phase)
+					mPhaseTimes[phase].push_back(world.getPhaseTime(static_cast<World::Phase>(phase)));
+			}
+
+			void write(std::ostream& stream, const StressScenario& scenario, bool windowed) const
+			{
+				stream << "{\n"
+					<< "\t\"scenario\": \"" << scenario.name << "\",\n"
+					<< "\t\"target\": \"" << (windowed ? "window" : "offscreen") << "\",\n"
+					<< "\t\"frames\": " << mFrameTimes.size() << ",\n"
+					<< "\t\"frameTime\": ";
+				writeSummary(stream, mFrameTimes);
+
+				stream << ",\n\t\"phases\": {";
+				for (std::size_t phase = 0; phase < World::PhaseCount; ++phase)
+				{
+					stream << (phase == 0 ? "\n" : ",\n") << "\t\t\"" << PhaseNames[phase] << "\": ";
+					writeSummary(stream, mPhaseTimes[phase]);
+				}
+				stream << "\n\t}\n}\n";
+			}
+
+		private:
+			// Milliseconds
+			static void writeSummary(std::ostream& stream, std::vector<sf::Time> times)
+			{
+				if (times.empty())
+				{
+					stream << "null";
+					return;
+				}
+
+				std::sort(times.begin(), times.end());
+
+				sf::Int64 total = 0;
+				FOREACH(sf::Time time, times)
+					total += time.asMicroseconds();
+
+				stream << "{ \"mean\": " << total / 1000.0 / times.size()
+					<< ", \"p50\": " << percentile(times, 0.5)
+					<< ", \"p90\": " << percentile(times, 0.9)
+					<< ", \"p99\": " << percentile(times, 0.99)
+					<< ", \"p99.9\": " << percentile(times, 0.999)
+					<< ", \"max\": " << times.back().asMicroseconds() / 1000.0 << " }";
+			}
+
+			static double percentile(const std::vector<sf::Time>& sortedTimes, double fraction)
+			{
+				std::size_t index = std::min(static_cast<std::size_t>(fraction * sortedTimes.size()), sortedTimes.size() - 1);
+				return sortedTimes[index].asMicroseconds() / 1000.0;
+			}
+
+		private:
+			std::vector<sf::Time>								mFrameTimes;
+			std::array<std::vector<sf::Time>, World::PhaseCount>	mPhaseTimes;
+	};
+}
+
+int main(int argc, char* argv[])
+{
+	std::vector<std::string> arguments(argv + 1, argv + argc);
+	bool windowed = std::find(arguments.begin(), arguments.end(), "--window") != arguments.end();
+	arguments.erase(std::remove(arguments.begin(), arguments.end(), "--window"), arguments.end());
+
+	if (arguments.empty())
+	{
+		std::cerr << "Usage: " << argv[0] << " <scenario> [<report.json>] [--window]" << std::endl;
+		return 1;
+	}
+
+	try
+	{
+		StressScenario scenario;
+		scenario.loadFromFile(arguments[0]);
+
+		// Both are render targets; the world does not care which one it draws into
+		std::unique_ptr<sf::RenderWindow> window;
+		std::unique_ptr<sf::RenderTexture> texture;
+		sf::RenderTarget* target;
+		if (windowed)
+		{
+			window.reset(new sf::RenderWindow(sf::VideoMode(Width, Height), "Stress: " + scenario.name, sf::Style::Close));
+			window->setVerticalSyncEnabled(false);
+			target = window.get();
+		}
+		else
+		{
+			texture.reset(new sf::RenderTexture());
+			if (!texture->create(Width, Height))
+				throw std::runtime_error("Failed to create the off-screen render target");
+
+			target = texture.get();
+		}
+
+		AssetArchive archive("Media.pak");
+		ResourceLoader loader;
+		TextureHolder textures;
+		ShaderHolder shaders;
+		FontHolder fonts;
+		SoundPlayer sounds(loader, archive);
+		Statistics statistics;
+
+		textures.setArchive(archive);
+		shaders.setArchive(archive);
+		fonts.setArchive(archive);
+		fonts.load(Fonts::Main, "Media/Sansation.ttf");
+
+		World::loadResources(loader, textures, shaders);
+		while (!loader.isFinished())
+		{
+			loader.update(sf::seconds(1.f));
+			sf::sleep(sf::milliseconds(1));
+		}
+
+		World world(*target, textures, shaders, fonts, sounds, statistics);
+		world.setStressScenario(scenario);
+
+		// Fixed steps, so every run simulates the same frames regardless of speed
+		StressReport report;
+		sf::Clock frameClock;
+		for (sf::Time simulated = sf::Time::Zero; simulated < scenario.duration; simulated += TimePerFrame)
+		{
+			if (window)
+			{
+				sf::Event event;
+				while (window->pollEvent(event))
+				{
+					if (event.type == sf::Event::Closed)
+						window->close();
+				}
+
+				if (!window->isOpen())
+					break;
+			}
+
+			world.update(TimePerFrame);
+			world.draw();
+
+			if (window)
+				window->display();
+			else
+				texture->display();
+
+			report.addFrame(frameClock.restart(), world);
+		}
+
+		if (arguments.size() > 1)
+		{
+			std::ofstream output(arguments[1].c_str());
+			report.write(output, scenario, windowed);
+			if (!output)
+				throw std::runtime_error("Failed to write " + arguments[1]);
+		}
+		else
+		{
+			report.write(std::cout, scenario, windowed);
+		}
+	}
+	catch (std::exception& e)
+	{
+		std::cerr << "EXCEPTION: " << e.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
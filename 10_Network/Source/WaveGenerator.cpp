@@ -0,0 +1,73 @@
+#include <Book/WaveGenerator.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+
+namespace
+{
+	const float PlaneSpacingX = 80.f;
+	const float PlaneSpacingY = 120.f;
+
+	// Waves until the difficulty stops increasing
+	const float FullDifficultyWaves = 40.f;
+}
+
+WaveGenerator::WaveGenerator(unsigned int seed, float maxOffsetX)
+: mRandom(seed)
+, mMaxOffsetX(maxOffsetX)
+, mWaveCount(0)
+{
+}
+
+float WaveGenerator::generate(std::vector<Level::Spawn>& spawns)
+{
+	float difficulty = std::min(mWaveCount / FullDifficultyWaves, 1.f);
+	++mWaveCount;
+
+	// Larger waves, more Avengers and shorter breaks as the difficulty grows
+	std::uniform_int_distribution<int> formationDistribution(0, FormationCount - 1);
+	std::uniform_int_distribution<int> sizeDistribution(1, 2 + static_cast<int>(difficulty * 4.f));
+	std::bernoulli_distribution avengerDistribution(0.1 + 0.5 * difficulty);
+	std::uniform_real_distribution<float> gapDistribution(200.f, 500.f - 250.f * difficulty);
+
+	Formation formation = static_cast<Formation>(formationDistribution(mRandom));
+	int size = sizeDistribution(mRandom);
+	Aircraft::Type type = avengerDistribution(mRandom) ? Aircraft::Avenger : Aircraft::Raptor;
+
+	float halfWidth = (formation == Column) ? 0.f : (size - 1) * PlaneSpacingX / 2.f;
+	float centerRange = std::max(mMaxOffsetX - halfWidth, 0.f);
+	float center = std::uniform_real_distribution<float>(-centerRange, centerRange)(mRandom);
+
+	float length = 0.f;
+	for (int i = 0; i < size; ++i)
+	{
+		// Position within the formation, relative to its middle
+		float slot = i - (size - 1) / 2.f;
+
+		Level::Spawn spawn(type, center, 0.f);
+		switch (formation)
+		{
+			case Line:
+				spawn.x += slot * PlaneSpacingX;
+				break;
+
+			case Column:
+				spawn.distance = i * PlaneSpacingY;
+				break;
+
+			case Wedge:
+				spawn.x += slot * PlaneSpacingX;
+				spawn.distance = std::abs(slot) * PlaneSpacingY;
+				break;
+
+			default:
+				break;
+		}
+
+		spawns.push_back(spawn);
+		length = std::max(length, spawn.distance);
+	}
+
+	return length + gapDistribution(mRandom);
+}
@@ -0,0 +1,119 @@
+#include <Book/WorkerGroup.hpp>
+
+#include <algorithm>
+#include <thread>
+
+
+WorkerGroup::WorkerGroup(std::size_t threadCount)
+: mThreadCount(threadCount)
+, mWorkers()
+, mMutex()
+, mStartCondition()
+, mDoneCondition()
+, mTask(nullptr)
+, mRows(0)
+, mBandSize(0)
+, mBandCount(0)
+, mGeneration(0)
+, mPendingBands(0)
+, mStopRequested(false)
+{
+	if (mThreadCount == 0)
+		mThreadCount = std::max(1u, std::thread::hardware_concurrency());
+
+	// Band 0 always runs on the calling thread
+	for (std::size_t band = 1; band < mThreadCount; ++band)
+	{
+		mWorkers.push_back(std::unique_ptr<sf::Thread>(new sf::Thread(std::bind(&WorkerGroup::workerThread, this, band))));
+		mWorkers.back()->launch();
+	}
+}
+
+WorkerGroup::~WorkerGroup()
+{
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mStopRequested = true;
+	}
+
+	// sf::Thread's destructor waits for the woken workers to return
+	mStartCondition.notify_all();
+	mWorkers.clear();
+}
+
+void WorkerGroup::run(unsigned int rows, unsigned int minRowsPerBand, const Task& task)
+{
+	std::size_t bandCount = std::max<std::size_t>(1, std::min<std::size_t>(mThreadCount, rows / std::max(minRowsPerBand, 1u)));
+
+	// Too small to be worth waking anyone
+	if (bandCount == 1)
+	{
+		task(0, rows);
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mTask = &task;
+		mRows = rows;
+		mBandCount = bandCount;
+		mBandSize = static_cast<unsigned int>((rows + bandCount - 1) / bandCount);
+		mPendingBands = bandCount - 1;
+		++mGeneration;
+	}
+
+	mStartCondition.notify_all();
+	runBand(0);
+
+	std::unique_lock<std::mutex> lock(mMutex);
+	mDoneCondition.wait(lock, [this] () { return mPendingBands == 0; });
+	mTask = nullptr;
+}
+
+std::size_t WorkerGroup::getThreadCount() const
+{
+	return mThreadCount;
+}
+
+void WorkerGroup::workerThread(std::size_t band)
+{
+	std::size_t generation = 0;
+
+	for (;;)
+	{
+		{
+			std::unique_lock<std::mutex> lock(mMutex);
+			mStartCondition.wait(lock, [&] () { return mStopRequested || mGeneration != generation; });
+
+			if (mStopRequested)
+				return;
+
+			generation = mGeneration;
+
+			// Runs with fewer bands than threads leave the last workers idle
+			if (band >= mBandCount)
+				continue;
+		}
+
+		runBand(band);
+
+		bool last;
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			last = (--mPendingBands == 0);
+		}
+
+		if (last)
+			mDoneCondition.notify_one();
+	}
+}
+
+void WorkerGroup::runBand(std::size_t band)
+{
+	// Only read while the run is in progress, when the calling thread doesn't write these
+	unsigned int begin = static_cast<unsigned int>(band) * mBandSize;
+	unsigned int end = std::min(mRows, begin + mBandSize);
+
+	if (begin < end)
+		(*mTask)(begin, end);
+}
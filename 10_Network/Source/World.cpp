@@ -4,43 +4,122 @@
 #include <Book/Foreach.hpp>
 #include <Book/TextNode.hpp>
 #include <Book/ParticleNode.hpp>
+#include <Book/BackgroundNode.hpp>
+#include <Book/EmitterNode.hpp>
 #include <Book/SoundNode.hpp>
 #include <Book/NetworkNode.hpp>
 #include <Book/Utility.hpp>
+#include <Book/BloomEffect.hpp>
+#include <Book/SoftwareBloomEffect.hpp>
+#include <Book/Statistics.hpp>
+#include <Book/Profiler.hpp>
 #include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/OpenGL.hpp>
 
 #include <algorithm>
 #include <cmath>
 #include <limits>
+#include <cassert>
 
 
-World::World(sf::RenderTarget& outputTarget, FontHolder& fonts, SoundPlayer& sounds, bool networked)
+namespace
+{
+	struct TextureFile
+	{
+		Textures::ID	id;
+		const char*		filename;
+	};
+
+	const TextureFile GameTextures[] =
+	{
+		{ Textures::Entities,	"Media/Textures/Entities.png" },
+		{ Textures::Jungle,		"Media/Textures/Jungle.png" },
+		{ Textures::Explosion,	"Media/Textures/Explosion.png" },
+		{ Textures::Particle,	"Media/Textures/Particle.png" },
+		{ Textures::FinishLine,	"Media/Textures/FinishLine.png" },
+	};
+
+	const std::size_t GameTextureCount = sizeof(GameTextures) / sizeof(GameTextures[0]);
+
+	// Share of a 60 FPS frame left for rendering; update, events and the buffer swap need the rest
+	const sf::Time RenderBudget = sf::milliseconds(12);
+
+	// Frames between two measurements of the GPU's rendering time
+	const std::size_t GpuSampleInterval = 4;
+}
+
+World::World(sf::RenderTarget& outputTarget, TextureHolder& textures, ShaderHolder& shaders,
+	FontHolder& fonts, SoundPlayer& sounds, Statistics& statistics, bool networked)
 : mTarget(outputTarget)
-, mSceneTexture()
 , mWorldView(outputTarget.getDefaultView())
-, mTextures() 
+, mPreviousViewCenter()
+, mInterpolation(1.f)
+, mTextures(textures)
 , mFonts(fonts)
 , mSounds(sounds)
+, mStatistics(statistics)
 , mSceneGraph()
 , mSceneLayers()
 , mWorldBounds(0.f, 0.f, mWorldView.getSize().x, 5000.f)
 , mSpawnPosition(mWorldView.getSize().x / 2.f, mWorldBounds.height - mWorldView.getSize().y / 2.f)
+, mOriginY(mSpawnPosition.y)
 , mScrollSpeed(-50.f)
 , mScrollSpeedCompensation(1.f)
 , mPlayerAircrafts()
+, mAircraftTable()
+, mAircraftHandles()
+, mLevel()
+, mNextLevelSpawn(0)
 , mEnemySpawnPoints()
 , mActiveEnemies()
+, mRenderTargets()
+, mPostEffects(mRenderTargets)
+, mResolutionScaler(0.5f, RenderBudget)
+, mFramesSinceGpuSample(0)
+, mCommandsDispatched(0)
+, mCollisionTests(0)
+, mCollisionsFound(0)
+, mStatisticsClock()
+, mPhaseTimes()
+, mStressScenario()
+, mStressPopulation()
+, mStressEmitterLayer(nullptr)
+, mStressRandom()
+, mWaveGenerator()
+, mNextWaveY(0.f)
 , mNetworkedWorld(networked)
 , mNetworkNode(nullptr)
 , mFinishSprite(nullptr)
+, mBackground(nullptr)
 {
-	mSceneTexture.create(mTarget.getSize().x, mTarget.getSize().y);
+	// Without shader support, bloom is computed on the CPU
+	if (PostEffect::isSupported())
+		mPostEffects.addEffect(PostEffectChain::Ptr(new BloomEffect(mRenderTargets, shaders)));
+	else
+		mPostEffects.addEffect(PostEffectChain::Ptr(new SoftwareBloomEffect()));
+
+	// Keep the textures resident in the shared cache while this world exists
+	for (std::size_t i = 0; i < GameTextureCount; ++i)
+		mTextures.acquire(GameTextures[i].id);
 
-	loadTextures();
 	buildScene();
 
 	// Prepare the view
 	mWorldView.setCenter(mSpawnPosition);
+	mPreviousViewCenter = mSpawnPosition;
+}
+
+World::~World()
+{
+	// Scene nodes referencing the textures are destroyed after this body; nothing is drawn in between
+	for (std::size_t i = 0; i < GameTextureCount; ++i)
+		mTextures.release(GameTextures[i].id);
+
+	mStatistics.removeValue("Resolution");
+	mStatistics.removeValue("Scene");
+	mStatistics.removeValue("Entities");
+	mStatistics.removeValue("Collisions");
+	mStatistics.removeValue("Commands");
 }
 
 void World::setWorldScrollCompensation(float compensation)
@@ -50,55 +129,188 @@ void World::setWorldScrollCompensation(float compensation)
 
 void World::update(sf::Time dt)
 {
+	BOOK_PROFILE_ZONE("World::update");
+
 	// Scroll the world, reset player velocity
+	mPreviousViewCenter = mWorldView.getCenter();
 	mWorldView.move(0.f, mScrollSpeed * dt.asSeconds() * mScrollSpeedCompensation);	
+	updateFloatingOrigin();
 
 	FOREACH(Aircraft* a, mPlayerAircrafts)
 		a->setVelocity(0.f, 0.f);
 
-	// Setup commands to destroy entities, and guide missiles
-	destroyEntitiesOutsideView();
-	guideMissiles();
+	sf::Clock phaseClock;
+	{
+		BOOK_PROFILE_ZONE("World::commands");
 
-	// Forward commands to scene graph, adapt velocity (scrolling, diagonal correction)
-	while (!mCommandQueue.isEmpty())
-		mSceneGraph.onCommand(mCommandQueue.pop(), dt);
+		// Setup commands to destroy entities, and guide missiles
+		destroyEntitiesOutsideView();
+		guideMissiles();
 
-	adaptPlayerVelocity();
+		// Forward commands to scene graph, adapt velocity (scrolling, diagonal correction)
+		mCommandsDispatched = 0;
+		while (!mCommandQueue.isEmpty())
+		{
+			Command command = mCommandQueue.pop();
 
-	// Collision detection and response (may destroy entities)
-	handleCollisions();
+			// Commands for a single aircraft skip the scene graph traversal
+			if (command.target.isValid())
+			{
+				if (Aircraft* aircraft = mAircraftTable.get(command.target))
+					command.action(*aircraft, dt);
+			}
+			else
+			{
+				mSceneGraph.onCommand(command, dt);
+			}
 
-	// Remove aircrafts that were destroyed (World::removeWrecks() only destroys the entities, not the pointers in mPlayerAircraft)
-	auto firstToRemove = std::remove_if(mPlayerAircrafts.begin(), mPlayerAircrafts.end(), std::mem_fn(&Aircraft::isMarkedForRemoval));
-	mPlayerAircrafts.erase(firstToRemove, mPlayerAircrafts.end());
+			++mCommandsDispatched;
+		}
 
-	// Remove all destroyed entities, create new ones
-	mSceneGraph.removeWrecks();
-	spawnEnemies();
+		adaptPlayerVelocity();
+		mPhaseTimes[CommandPhase] = phaseClock.restart();
+	}
+
+	{
+		BOOK_PROFILE_ZONE("World::collisions");
+
+		// Collision detection and response (may destroy entities)
+		handleCollisions();
+		mPhaseTimes[CollisionPhase] = phaseClock.restart();
+	}
+
+	{
+		BOOK_PROFILE_ZONE("World::removeWrecks");
+
+		// Remove aircrafts that were destroyed (World::removeWrecks() only destroys the entities, not the pointers in mPlayerAircraft)
+		auto firstToRemove = std::remove_if(mPlayerAircrafts.begin(), mPlayerAircrafts.end(), std::mem_fn(&Aircraft::isMarkedForRemoval));
+		for (auto itr = firstToRemove; itr != mPlayerAircrafts.end(); ++itr)
+			mAircraftTable.remove(getAircraftHandle((*itr)->getIdentifier()));
+
+		mPlayerAircrafts.erase(firstToRemove, mPlayerAircrafts.end());
+
+		// Remove all destroyed entities
+		mSceneGraph.removeWrecks();
+		mPhaseTimes[RemoveWrecksPhase] = phaseClock.restart();
+	}
 
-	// Regular update step, adapt position (correct if outside view)
-	mSceneGraph.update(dt, mCommandQueue);
-	adaptPlayerPosition();
+	{
+		BOOK_PROFILE_ZONE("World::spawn");
+		spawnEnemies();
+		maintainStressScenario();
+		mPhaseTimes[SpawnPhase] = phaseClock.restart();
+	}
+
+	{
+		BOOK_PROFILE_ZONE("World::graphUpdate");
+
+		// Regular update step, adapt position (correct if outside view)
+		mSceneGraph.update(dt, mCommandQueue);
+		adaptPlayerPosition();
+		mPhaseTimes[GraphUpdatePhase] = phaseClock.restart();
+	}
 
-	updateSounds();
+	{
+		BOOK_PROFILE_ZONE("World::sounds");
+		updateSounds();
+		mPhaseTimes[SoundPhase] = phaseClock.restart();
+	}
 }
 
 void World::draw()
 {
-	if (PostEffect::isSupported())
+	BOOK_PROFILE_ZONE("World::draw");
+
+	// Render the state between the last two simulation steps
+	sf::View view = mWorldView;
+	view.setCenter(mPreviousViewCenter + (mWorldView.getCenter() - mPreviousViewCenter) * mInterpolation);
+	mSceneGraph.interpolate(mInterpolation);
+
+	updateStatistics();
+
+	// Render the scene at the current resolution scale; the post effects upscale it into the output
+	sf::Vector2u sceneSize = mResolutionScaler.getScaledSize(mTarget.getSize());
+	sf::RenderTexture& sceneTexture = mRenderTargets.acquire(sceneSize, mResolutionScaler.getScale() < 1.f);
+
+	// Draw calls only queue GPU work, the fill cost shows up later in the buffer swap. On sampled frames the GPU
+	// is drained before and after rendering, so the time covers its work too; doing that every frame would stall it.
+	bool sampleGpu = (++mFramesSinceGpuSample >= GpuSampleInterval);
+	if (sampleGpu)
 	{
-		mSceneTexture.clear();
-		mSceneTexture.setView(mWorldView);
-		mSceneTexture.draw(mSceneGraph);
-		mSceneTexture.display();
-		mBloomEffect.apply(mSceneTexture, mTarget);
+		mFramesSinceGpuSample = 0;
+		glFinish();
 	}
-	else
+
+	sf::Clock renderClock;
+	sf::Clock phaseClock;
 	{
-		mTarget.setView(mWorldView);
-		mTarget.draw(mSceneGraph);
+		BOOK_PROFILE_ZONE("World::drawScene");
+		sceneTexture.clear();
+		sceneTexture.setView(view);
+		sceneTexture.draw(mSceneGraph);
+		sceneTexture.display();
+		mPhaseTimes[DrawScenePhase] = phaseClock.restart();
 	}
+
+	{
+		BOOK_PROFILE_ZONE("World::postEffects");
+		mPostEffects.apply(sceneTexture, mTarget);
+		mPhaseTimes[PostEffectPhase] = phaseClock.restart();
+	}
+
+	// The new scale applies from the next frame on
+	if (sampleGpu)
+	{
+		BOOK_PROFILE_ZONE("World::finishRendering");
+		glFinish();
+		updateResolutionScale(renderClock.getElapsedTime());
+	}
+
+	mRenderTargets.release(sceneTexture);
+	mRenderTargets.collectUnused();
+}
+
+void World::setMinResolutionScale(float minScale)
+{
+	mResolutionScaler.setMinScale(minScale);
+}
+
+void World::updateResolutionScale(sf::Time renderTime)
+{
+	// Only the rendering scales with resolution; update, event handling and vsync waits are left out
+	mResolutionScaler.addFrame(renderTime);
+
+	const char* decisions[] = { "kept", "lowered", "raised" };
+	mStatistics.setValue("Resolution", toString(static_cast<int>(mResolutionScaler.getScale() * 100.f + 0.5f)) + "% ("
+		+ decisions[mResolutionScaler.getLastDecision()] + ", "
+		+ toString(mResolutionScaler.getAverageFrameTime().asMicroseconds() / 1000.f) + " ms)");
+}
+
+void World::updateStatistics()
+{
+	// A few times per second is enough for display, and keeps the scene traversal cheap
+	if (mStatisticsClock.getElapsedTime() < sf::seconds(0.25f))
+		return;
+
+	mStatisticsClock.restart();
+
+	SceneStatistics scene;
+	mSceneGraph.collectStatistics(scene);
+
+	mStatistics.setValue("Scene", toString(scene.nodes) + " nodes, " + toString(scene.drawCalls) + " draw calls, "
+		+ toString(scene.particles) + " particles");
+	mStatistics.setValue("Entities", toString(scene.categories[Category::PlayerAircraft]) + " player, "
+		+ toString(scene.categories[Category::AlliedAircraft]) + " allied, "
+		+ toString(scene.categories[Category::EnemyAircraft]) + " enemy, "
+		+ toString(scene.categories[Category::AlliedProjectile] + scene.categories[Category::EnemyProjectile]) + " projectiles, "
+		+ toString(scene.categories[Category::Pickup]) + " pickups");
+	mStatistics.setValue("Collisions", toString(mCollisionTests) + " pairs tested, " + toString(mCollisionsFound) + " found");
+	mStatistics.setValue("Commands", toString(mCommandsDispatched) + " dispatched");
+}
+
+void World::setInterpolation(float alpha)
+{
+	mInterpolation = alpha;
 }
 
 CommandQueue& World::getCommandQueue()
@@ -108,13 +320,16 @@ CommandQueue& World::getCommandQueue()
 
 Aircraft* World::getAircraft(int identifier) const
 {
-	FOREACH(Aircraft* a, mPlayerAircrafts)
-	{
-		if (a->getIdentifier() == identifier)
-			return a;
-	}
+	return mAircraftTable.get(getAircraftHandle(identifier));
+}
+
+Handle World::getAircraftHandle(int identifier) const
+{
+	// Identifiers are handed out in ascending order, the lookup vector stays small
+	if (identifier < 0 || static_cast<std::size_t>(identifier) >= mAircraftHandles.size())
+		return Handle();
 
-	return nullptr;
+	return mAircraftHandles[identifier];
 }
 
 void World::removeAircraft(int identifier)
@@ -123,6 +338,7 @@ void World::removeAircraft(int identifier)
 	if (aircraft)
 	{
 		aircraft->destroy();
+		mAircraftTable.remove(getAircraftHandle(identifier));
 		mPlayerAircrafts.erase(std::find(mPlayerAircrafts.begin(), mPlayerAircrafts.end(), aircraft));
 	}
 }
@@ -133,6 +349,14 @@ Aircraft* World::addAircraft(int identifier)
 	player->setPosition(mWorldView.getCenter());
 	player->setIdentifier(identifier);
 
+	// An identifier refers to one aircraft at a time
+	assert(identifier >= 0);
+	removeAircraft(identifier);
+
+	if (static_cast<std::size_t>(identifier) >= mAircraftHandles.size())
+		mAircraftHandles.resize(identifier + 1);
+
+	mAircraftHandles[identifier] = mAircraftTable.insert(*player);
 	mPlayerAircrafts.push_back(player.get());
 	mSceneLayers[UpperAir]->attachChild(std::move(player));
 	return mPlayerAircrafts.back();
@@ -151,9 +375,63 @@ bool World::pollGameAction(GameActions::Action& out)
 	return mNetworkNode->pollGameAction(out);
 }
 
+void World::setStressScenario(const StressScenario& scenario)
+{
+	assert(!mStressScenario);
+
+	mStressScenario.reset(new StressScenario(scenario));
+	mStressRandom.seed(scenario.seed);
+
+	// The scenario replaces the level's enemies
+	mNextLevelSpawn = mLevel.getSpawnCount();
+	mEnemySpawnPoints = std::priority_queue<SpawnPoint>();
+
+	// Keep full resolution, so that render costs are comparable between runs
+	mResolutionScaler = ResolutionScaler(1.f, sf::seconds(1.f / 60.f));
+
+	// Emitters are placed once, on a layer that follows the view
+	std::unique_ptr<SceneNode> emitterLayer(new SceneNode());
+	mStressEmitterLayer = emitterLayer.get();
+
+	std::uniform_real_distribution<float> x(0.f, mWorldView.getSize().x);
+	std::uniform_real_distribution<float> y(0.f, mWorldView.getSize().y);
+	for (std::size_t type = 0; type < Particle::ParticleCount; ++type)
+	{
+		for (std::size_t i = 0; i < scenario.population.emitters[type]; ++i)
+		{
+			std::unique_ptr<EmitterNode> emitter(new EmitterNode(static_cast<Particle::Type>(type)));
+			emitter->setPosition(x(mStressRandom), y(mStressRandom));
+			mStressEmitterLayer->attachChild(std::move(emitter));
+		}
+	}
+
+	mSceneLayers[LowerAir]->attachChild(std::move(emitterLayer));
+}
+
+void World::setEndlessMode(unsigned int seed)
+{
+	assert(!mWaveGenerator && !mStressScenario);
+
+	// Formations keep some distance to the screen edges
+	mWaveGenerator.reset(new WaveGenerator(seed, mWorldView.getSize().x / 2.f - 100.f));
+	mNextWaveY = mSpawnPosition.y - 500.f;
+
+	// The waves replace the level's enemies, and there is no finish line to reach
+	mNextLevelSpawn = mLevel.getSpawnCount();
+	mEnemySpawnPoints = std::priority_queue<SpawnPoint>();
+	mSceneLayers[Background]->detachChild(*mFinishSprite);
+	mFinishSprite = nullptr;
+}
+
+sf::Time World::getPhaseTime(Phase phase) const
+{
+	return mPhaseTimes[phase];
+}
+
 void World::setCurrentBattleFieldPosition(float lineY)
 {
 	mWorldView.setCenter(mWorldView.getCenter().x, lineY - mWorldView.getSize().y/2);
+	mPreviousViewCenter = mWorldView.getCenter();
 	mSpawnPosition.y = mWorldBounds.height; 
 }
 
@@ -169,19 +447,26 @@ bool World::hasAlivePlayer() const
 
 bool World::hasPlayerReachedEnd() const
 {
+	if (mWaveGenerator)
+		return false;
+
 	if (Aircraft* aircraft = getAircraft(1))
 		return !mWorldBounds.contains(aircraft->getPosition());
 	else 
 		return false;
 }
 
-void World::loadTextures()
+void World::loadResources(ResourceLoader& loader, TextureHolder& textures, ShaderHolder& shaders)
 {
-	mTextures.load(Textures::Entities, "Media/Textures/Entities.png");
-	mTextures.load(Textures::Jungle, "Media/Textures/Jungle.png");
-	mTextures.load(Textures::Explosion, "Media/Textures/Explosion.png");
-	mTextures.load(Textures::Particle, "Media/Textures/Particle.png");
-	mTextures.load(Textures::FinishLine, "Media/Textures/FinishLine.png");
+	// Only textures evicted from the shared cache since the last game are loaded again
+	for (std::size_t i = 0; i < GameTextureCount; ++i)
+	{
+		if (!textures.contains(GameTextures[i].id))
+			textures.loadAsync(loader, GameTextures[i].id, GameTextures[i].filename);
+	}
+
+	if (PostEffect::isSupported())
+		BloomEffect::loadShaders(loader, shaders);
 }
 
 void World::adaptPlayerPosition()
@@ -240,7 +525,9 @@ bool matchesCategories(SceneNode::Pair& colliders, Category::Type type1, Categor
 void World::handleCollisions()
 {
 	std::set<SceneNode::Pair> collisionPairs;
-	mSceneGraph.checkSceneCollision(mSceneGraph, collisionPairs);
+	mCollisionTests = 0;
+	mSceneGraph.checkSceneCollision(mSceneGraph, collisionPairs, mCollisionTests);
+	mCollisionsFound = collisionPairs.size();
 
 	FOREACH(SceneNode::Pair pair, collisionPairs)
 	{
@@ -297,11 +584,8 @@ void World::updateSounds()
 		listenerPosition /= static_cast<float>(mPlayerAircrafts.size());
 	}
 
-	// Set listener's position
+	// Set listener's position, against which distant sounds are culled
 	mSounds.setListenerPosition(listenerPosition);
-
-	// Remove unused sounds
-	mSounds.removeStoppedSounds();
 }
 
 void World::buildScene()
@@ -317,18 +601,11 @@ void World::buildScene()
 		mSceneGraph.attachChild(std::move(layer));
 	}
 
-	// Prepare the tiled background
-	sf::Texture& jungleTexture = mTextures.get(Textures::Jungle);
-	jungleTexture.setRepeated(true);
-
-	float viewHeight = mWorldView.getSize().y;
-	sf::IntRect textureRect(mWorldBounds);
-	textureRect.height += static_cast<int>(viewHeight);
-
-	// Add the background sprite to the scene
-	std::unique_ptr<SpriteNode> jungleSprite(new SpriteNode(jungleTexture, textureRect));
-	jungleSprite->setPosition(mWorldBounds.left, mWorldBounds.top - viewHeight);
-	mSceneLayers[Background]->attachChild(std::move(jungleSprite));
+	// Add the tiled background to the scene; it only builds the part around the view, however long the world is
+	std::unique_ptr<BackgroundNode> jungle(new BackgroundNode(mTextures.get(Textures::Jungle), mWorldBounds.width));
+	jungle->setPosition(mWorldBounds.left, 0.f);
+	mBackground = jungle.get();
+	mSceneLayers[Background]->attachChild(std::move(jungle));
 
 	// Add the finish line to the scene
 	sf::Texture& finishTexture = mTextures.get(Textures::FinishLine);
@@ -366,69 +643,189 @@ void World::addEnemies()
 	if (mNetworkedWorld)
 		return;
 
-	// Add enemies to the spawn point container
-	addEnemy(Aircraft::Raptor,    0.f,  500.f);
-	addEnemy(Aircraft::Raptor,    0.f, 1000.f);
-	addEnemy(Aircraft::Raptor, +100.f, 1150.f);
-	addEnemy(Aircraft::Raptor, -100.f, 1150.f);
-	addEnemy(Aircraft::Avenger,  70.f, 1500.f);
-	addEnemy(Aircraft::Avenger, -70.f, 1500.f);
-	addEnemy(Aircraft::Avenger, -70.f, 1710.f);
-	addEnemy(Aircraft::Avenger,  70.f, 1700.f);
-	addEnemy(Aircraft::Avenger,  30.f, 1850.f);
-	addEnemy(Aircraft::Raptor,  300.f, 2200.f);
-	addEnemy(Aircraft::Raptor, -300.f, 2200.f);
-	addEnemy(Aircraft::Raptor,    0.f, 2200.f);
-	addEnemy(Aircraft::Raptor,    0.f, 2500.f);
-	addEnemy(Aircraft::Avenger,-300.f, 2700.f);
-	addEnemy(Aircraft::Avenger,-300.f, 2700.f);
-	addEnemy(Aircraft::Raptor,    0.f, 3000.f);
-	addEnemy(Aircraft::Raptor,  250.f, 3250.f);
-	addEnemy(Aircraft::Raptor, -250.f, 3250.f);
-	addEnemy(Aircraft::Avenger,   0.f, 3500.f);
-	addEnemy(Aircraft::Avenger,   0.f, 3700.f);
-	addEnemy(Aircraft::Raptor,    0.f, 3800.f);
-	addEnemy(Aircraft::Avenger,   0.f, 4000.f);
-	addEnemy(Aircraft::Avenger,-200.f, 4200.f);
-	addEnemy(Aircraft::Raptor,  200.f, 4200.f);
-	addEnemy(Aircraft::Raptor,    0.f, 4400.f);
-
-	sortEnemies();
-}
-
-void World::sortEnemies()
-{
-	// Sort all enemies according to their y value, such that lower enemies are checked first for spawning
-	std::sort(mEnemySpawnPoints.begin(), mEnemySpawnPoints.end(), [] (SpawnPoint lhs, SpawnPoint rhs)
-	{
-		return lhs.y < rhs.y;
-	});
+	// Spawns are sorted by distance in the file and read when the battlefield reaches them
+	mLevel.loadFromFile("Media/Levels/Mission.lvl");
+	mNextLevelSpawn = 0;
 }
 
 void World::addEnemy(Aircraft::Type type, float relX, float relY)
 {
 	SpawnPoint spawn(type, mSpawnPosition.x + relX, mSpawnPosition.y - relY);
-	mEnemySpawnPoints.push_back(spawn);
+	mEnemySpawnPoints.push(spawn);
 }
 
 void World::spawnEnemies()
 {
+	float battlefieldTop = getBattlefieldBounds().top;
+
 	// Spawn all enemies entering the view area (including distance) this frame
-	while (!mEnemySpawnPoints.empty()
-		&& mEnemySpawnPoints.back().y > getBattlefieldBounds().top)
+	while (mNextLevelSpawn < mLevel.getSpawnCount())
 	{
-		SpawnPoint spawn = mEnemySpawnPoints.back();
-		
-		std::unique_ptr<Aircraft> enemy(new Aircraft(spawn.type, mTextures, mFonts));
-		enemy->setPosition(spawn.x, spawn.y);
-		enemy->setRotation(180.f);
-		if (mNetworkedWorld) enemy->disablePickups();
+		Level::Spawn spawn = mLevel.getSpawn(mNextLevelSpawn);
+		float y = mSpawnPosition.y - spawn.distance;
+		if (y <= battlefieldTop)
+			break;
 
-		mSceneLayers[UpperAir]->attachChild(std::move(enemy));
+		spawnEnemy(spawn.type, mSpawnPosition.x + spawn.x, y);
+		++mNextLevelSpawn;
+	}
+
+	if (mWaveGenerator)
+		generateWaves();
+
+	while (!mEnemySpawnPoints.empty()
+		&& mEnemySpawnPoints.top().y > battlefieldTop)
+	{
+		SpawnPoint spawn = mEnemySpawnPoints.top();
+		spawnEnemy(spawn.type, spawn.x, spawn.y);
 
 		// Enemy is spawned, remove from the list to spawn
-		mEnemySpawnPoints.pop_back();
+		mEnemySpawnPoints.pop();
+	}
+}
+
+void World::spawnEnemy(Aircraft::Type type, float x, float y)
+{
+	std::unique_ptr<Aircraft> enemy(new Aircraft(type, mTextures, mFonts));
+	enemy->setPosition(x, y);
+	enemy->setRotation(180.f);
+	if (mNetworkedWorld) enemy->disablePickups();
+
+	mSceneLayers[UpperAir]->attachChild(std::move(enemy));
+}
+
+void World::generateWaves()
+{
+	// Only the next wave waits in the spawn queue, however long the game runs
+	std::vector<Level::Spawn> spawns;
+	while (mNextWaveY > getBattlefieldBounds().top)
+	{
+		float waveY = mNextWaveY;
+		mNextWaveY -= mWaveGenerator->generate(spawns);
+
+		FOREACH(const Level::Spawn& spawn, spawns)
+			mEnemySpawnPoints.push(SpawnPoint(spawn.type, mSpawnPosition.x + spawn.x, waveY - spawn.distance));
+
+		spawns.clear();
+	}
+}
+
+void World::updateFloatingOrigin()
+{
+	if (!mWaveGenerator || getViewBounds().top >= 0.f)
+		return;
+
+	// Move the view back to the fixed origin, in whole background chunks so that the background stays seamless.
+	// The origin itself is never rebased, so coordinates stay within one world height of it however far the flight goes.
+	float chunkHeight = mBackground->getChunkHeight();
+	float chunks = std::floor((mOriginY - mWorldView.getCenter().y) / chunkHeight);
+	if (chunks > 0.f)
+		rebase(sf::Vector2f(0.f, chunks * chunkHeight));
+}
+
+void World::rebase(sf::Vector2f offset)
+{
+	mWorldView.move(offset);
+	mPreviousViewCenter += offset;
+	mSpawnPosition += offset;
+	mNextWaveY += offset.y;
+
+	// Spawn points waiting in the queue, usually a single wave
+	std::vector<SpawnPoint> spawnPoints;
+	while (!mEnemySpawnPoints.empty())
+	{
+		spawnPoints.push_back(mEnemySpawnPoints.top());
+		mEnemySpawnPoints.pop();
+	}
+
+	FOREACH(SpawnPoint& spawn, spawnPoints)
+	{
+		spawn.x += offset.x;
+		spawn.y += offset.y;
+		mEnemySpawnPoints.push(spawn);
+	}
+
+	// Entities are placed directly in the layers; their children move along with them
+	for (std::size_t i = 0; i < LayerCount; ++i)
+		mSceneLayers[i]->rebaseChildren(offset);
+}
+
+void World::maintainStressScenario()
+{
+	if (!mStressScenario)
+		return;
+
+	const StressScenario::Population& target = mStressScenario->population;
+	sf::FloatRect viewBounds = getViewBounds();
+	mStressEmitterLayer->setPosition(viewBounds.left, viewBounds.top);
+
+	// Replace what was destroyed or left the battlefield, according to last update's count
+	for (std::size_t type = 0; type < Aircraft::TypeCount; ++type)
+	{
+		for (std::size_t i = mStressPopulation.enemies[type]; i < target.enemies[type]; ++i)
+		{
+			std::unique_ptr<Aircraft> enemy(new Aircraft(static_cast<Aircraft::Type>(type), mTextures, mFonts));
+			enemy->setPosition(getRandomBattlefieldPosition());
+			enemy->setRotation(180.f);
+			mSceneLayers[UpperAir]->attachChild(std::move(enemy));
+		}
+	}
+
+	for (std::size_t type = 0; type < Projectile::TypeCount; ++type)
+	{
+		for (std::size_t i = mStressPopulation.projectiles[type]; i < target.projectiles[type]; ++i)
+		{
+			std::unique_ptr<Projectile> projectile(new Projectile(static_cast<Projectile::Type>(type), mTextures));
+			float sign = (type == Projectile::EnemyBullet) ? +1.f : -1.f;
+			projectile->setPosition(getRandomBattlefieldPosition());
+			projectile->setVelocity(0.f, sign * projectile->getMaxSpeed());
+			mSceneLayers[LowerAir]->attachChild(std::move(projectile));
+		}
 	}
+
+	std::uniform_int_distribution<int> pickupType(0, Pickup::TypeCount - 1);
+	for (std::size_t i = mStressPopulation.pickups; i < target.pickups; ++i)
+		createPickup(getRandomBattlefieldPosition(), static_cast<Pickup::Type>(pickupType(mStressRandom)));
+
+	// Count again during the next update; entities that are destroyed or outside the battlefield are out of play
+	mStressPopulation = StressScenario::Population();
+
+	Command enemyCounter;
+	enemyCounter.category = Category::EnemyAircraft;
+	enemyCounter.action = derivedAction<Aircraft>([this] (Aircraft& enemy, sf::Time)
+	{
+		if (!enemy.isDestroyed() && getBattlefieldBounds().intersects(enemy.getBoundingRect()))
+			++mStressPopulation.enemies[enemy.getType()];
+	});
+
+	Command projectileCounter;
+	projectileCounter.category = Category::Projectile;
+	projectileCounter.action = derivedAction<Projectile>([this] (Projectile& projectile, sf::Time)
+	{
+		if (!projectile.isDestroyed() && getBattlefieldBounds().intersects(projectile.getBoundingRect()))
+			++mStressPopulation.projectiles[projectile.getType()];
+	});
+
+	Command pickupCounter;
+	pickupCounter.category = Category::Pickup;
+	pickupCounter.action = derivedAction<Pickup>([this] (Pickup& pickup, sf::Time)
+	{
+		if (!pickup.isDestroyed() && getBattlefieldBounds().intersects(pickup.getBoundingRect()))
+			++mStressPopulation.pickups;
+	});
+
+	mCommandQueue.push(enemyCounter);
+	mCommandQueue.push(projectileCounter);
+	mCommandQueue.push(pickupCounter);
+}
+
+sf::Vector2f World::getRandomBattlefieldPosition()
+{
+	sf::FloatRect bounds = getBattlefieldBounds();
+	std::uniform_real_distribution<float> x(bounds.left, bounds.left + bounds.width);
+	std::uniform_real_distribution<float> y(bounds.top, bounds.top + bounds.height);
+
+	return sf::Vector2f(x(mStressRandom), y(mStressRandom));
 }
 
 void World::destroyEntitiesOutsideView()